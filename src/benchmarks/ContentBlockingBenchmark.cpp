@@ -0,0 +1,370 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "../core/AdblockContentFiltersMatcher.h"
+#include "../core/AdblockContentFiltersProfile.h"
+#include "../core/SessionsManager.h"
+#include "../core/SettingsManager.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace Otter;
+
+struct ListInformation final
+{
+	QString path;
+	qint64 parseTime = 0;
+	qint64 cacheLoadTime = 0;
+	int rulesAmount = 0;
+	bool hasCache = false;
+};
+
+quint64 getPeakMemoryUsage()
+{
+#ifdef Q_OS_UNIX
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef Q_OS_MACOS
+		return static_cast<quint64>(usage.ru_maxrss);
+#else
+		return (static_cast<quint64>(usage.ru_maxrss) * 1024);
+#endif
+	}
+#endif
+
+	return 0;
+}
+
+NetworkManager::ResourceType getResourceType(const QString &name)
+{
+	const QHash<QString, NetworkManager::ResourceType> resourceTypes({{QLatin1String("main_frame"), NetworkManager::MainFrameType}, {QLatin1String("subdocument"), NetworkManager::SubFrameType}, {QLatin1String("sub_frame"), NetworkManager::SubFrameType}, {QLatin1String("popup"), NetworkManager::PopupType}, {QLatin1String("stylesheet"), NetworkManager::StyleSheetType}, {QLatin1String("script"), NetworkManager::ScriptType}, {QLatin1String("image"), NetworkManager::ImageType}, {QLatin1String("object"), NetworkManager::ObjectType}, {QLatin1String("object-subrequest"), NetworkManager::ObjectSubrequestType}, {QLatin1String("xmlhttprequest"), NetworkManager::XmlHttpRequestType}, {QLatin1String("websocket"), NetworkManager::WebSocketType}});
+
+	return resourceTypes.value(name.toLower(), NetworkManager::OtherType);
+}
+
+QVector<qint64> replayRequests(const QVector<int> &profiles, const QVector<ContentFiltersManager::CheckRequest> &requests, bool canUseThreads, int &blockedAmount)
+{
+	QVector<qint64> latencies(requests.count());
+	qint64 *data(latencies.data());
+	QAtomicInt blockedRequestsAmount(0);
+	const int shardsAmount(canUseThreads ? qBound(1, QThread::idealThreadCount(), requests.count()) : 1);
+	QVector<QFuture<void> > futures;
+	futures.reserve(shardsAmount);
+
+	for (int i = 0; i < shardsAmount; ++i)
+	{
+		futures.append(QtConcurrent::run([&, i]()
+		{
+			QElapsedTimer timer;
+
+			for (int j = i; j < requests.count(); j += shardsAmount)
+			{
+				const ContentFiltersManager::CheckRequest &request(requests.at(j));
+
+				timer.start();
+
+				const bool isBlocked(ContentFiltersManager::checkUrl(profiles, request.baseUrl, request.requestUrl, request.resourceType).isBlocked);
+
+				data[j] = timer.nsecsElapsed();
+
+				if (isBlocked)
+				{
+					blockedRequestsAmount.ref();
+				}
+			}
+		}));
+	}
+
+	for (int i = 0; i < futures.count(); ++i)
+	{
+		futures[i].waitForFinished();
+	}
+
+	blockedAmount += blockedRequestsAmount.loadAcquire();
+
+	return latencies;
+}
+
+QString formatPercentile(QVector<qint64> latencies, int percentile)
+{
+	std::sort(latencies.begin(), latencies.end());
+
+	return QString::number((latencies.at(qMin((latencies.count() - 1), ((latencies.count() * percentile) / 100))) / 1000.0), 'f', 2);
+}
+
+bool loadList(ListInformation &information, const QString &cachePath)
+{
+	QFile file(information.path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return false;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	AdblockContentFiltersMatcher matcher;
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+	stream.readLine();
+
+	while (!stream.atEnd())
+	{
+		matcher.addRuleLine(stream.readLine(), ContentFiltersManager::AllFilters, true);
+	}
+
+	matcher.compile();
+
+	information.parseTime = timer.nsecsElapsed();
+	information.rulesAmount = matcher.getRulesAmount();
+
+	file.reset();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+
+	const QByteArray checksum(hash.result());
+
+	if (matcher.save(cachePath, checksum, 0))
+	{
+		AdblockContentFiltersMatcher cachedMatcher;
+
+		timer.restart();
+
+		if (cachedMatcher.load(cachePath, checksum, 0))
+		{
+			information.cacheLoadTime = timer.nsecsElapsed();
+			information.hasCache = true;
+		}
+	}
+
+	return true;
+}
+
+bool createProfile(const ListInformation &information, const QString &name)
+{
+	QFile file(information.path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return false;
+	}
+
+	ContentFiltersProfile::ProfileSummary profileSummary;
+	profileSummary.name = name;
+	profileSummary.areWildcardsEnabled = true;
+
+	return AdblockContentFiltersProfile::create(profileSummary, &file, true);
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication application(argc, argv);
+	QCoreApplication::setApplicationName(QLatin1String("otter-content-blocking-benchmark"));
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QLatin1String("Replays a corpus of requests against Adblock Plus lists.\nCorpus lines use the format: <type> <base URL> <request URL>"));
+	parser.addHelpOption();
+	parser.addPositionalArgument(QLatin1String("lists"), QLatin1String("Adblock Plus lists to load"), QLatin1String("[list...]"));
+	parser.addOption(QCommandLineOption(QLatin1String("corpus"), QLatin1String("Reads requests from <path>"), QLatin1String("path")));
+	parser.addOption(QCommandLineOption(QLatin1String("iterations"), QLatin1String("Replays corpus <amount> times, the first replay is reported as cold"), QLatin1String("amount"), QLatin1String("2")));
+	parser.addOption(QCommandLineOption(QLatin1String("threads"), QLatin1String("Shards each replay across threads")));
+	parser.process(application);
+
+	QTextStream output(stdout);
+	const QStringList paths(parser.positionalArguments());
+
+	if (paths.isEmpty() || !parser.isSet(QLatin1String("corpus")))
+	{
+		parser.showHelp(1);
+	}
+
+	QTemporaryDir profileDirectory;
+	const QString profilePath(profileDirectory.path());
+	const QString cachePath(QDir(profilePath).filePath(QLatin1String("cache")));
+
+	SettingsManager::createInstance(profilePath);
+	SessionsManager::createInstance(profilePath, cachePath);
+	ContentFiltersManager::createInstance();
+
+	Utils::ensureDirectoryExists(cachePath);
+
+	QVector<ListInformation> lists;
+	QStringList names;
+
+	for (int i = 0; i < paths.count(); ++i)
+	{
+		ListInformation information;
+		information.path = paths.at(i);
+
+		const QString name(QLatin1String("benchmark") + QString::number(i));
+
+		if (!loadList(information, QDir(cachePath).filePath(name + QLatin1String(".cache"))) || !createProfile(information, name))
+		{
+			output << "Failed to load list: " << information.path << Qt::endl;
+
+			return 1;
+		}
+
+		lists.append(information);
+		names.append(name);
+	}
+
+	QEventLoop eventLoop;
+	int loadedAmount(0);
+
+	for (int i = 0; i < names.count(); ++i)
+	{
+		ContentFiltersProfile *profile(ContentFiltersManager::getProfile(names.at(i)));
+
+		QObject::connect(profile, &ContentFiltersProfile::rulesModified, &eventLoop, [&]()
+		{
+			++loadedAmount;
+
+			if (loadedAmount == names.count())
+			{
+				eventLoop.quit();
+			}
+		});
+
+		profile->load();
+	}
+
+	eventLoop.exec();
+
+	QFile corpusFile(parser.value(QLatin1String("corpus")));
+
+	if (!corpusFile.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		output << "Failed to open corpus: " << corpusFile.errorString() << Qt::endl;
+
+		return 1;
+	}
+
+	QVector<ContentFiltersManager::CheckRequest> requests;
+	QTextStream corpusStream(&corpusFile);
+	corpusStream.setCodec("UTF-8");
+
+	while (!corpusStream.atEnd())
+	{
+		const QString line(corpusStream.readLine().trimmed());
+
+		if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+		{
+			continue;
+		}
+
+		const QStringList fields(line.split(QLatin1Char(' '), Qt::SkipEmptyParts));
+		ContentFiltersManager::CheckRequest request;
+
+		if (fields.count() >= 3)
+		{
+			request.baseUrl = QUrl(fields.at(1));
+			request.requestUrl = QUrl(fields.at(2));
+			request.resourceType = getResourceType(fields.at(0));
+		}
+		else
+		{
+			request.requestUrl = QUrl(fields.last());
+		}
+
+		requests.append(request);
+	}
+
+	if (requests.isEmpty())
+	{
+		output << "Corpus is empty" << Qt::endl;
+
+		return 1;
+	}
+
+	const QVector<int> profiles(ContentFiltersManager::getProfileIdentifiers(names));
+	const int iterations(qMax(1, parser.value(QLatin1String("iterations")).toInt()));
+	const int requestsAmount(requests.count() * iterations);
+	const bool canUseThreads(parser.isSet(QLatin1String("threads")));
+
+	ContentFiltersManager::checkUrl(profiles, QUrl(QLatin1String("https://example.invalid/")), QUrl(QLatin1String("https://example.invalid/")), NetworkManager::OtherType);
+	QCoreApplication::processEvents();
+	QThreadPool::globalInstance()->waitForDone();
+	QCoreApplication::processEvents();
+
+	const ContentFiltersManager::CheckResultsCacheStatistics initialStatistics(ContentFiltersManager::getCheckResultsCacheStatistics());
+	int blockedAmount(0);
+	QElapsedTimer timer;
+	timer.start();
+
+	const QVector<qint64> coldLatencies(replayRequests(profiles, requests, canUseThreads, blockedAmount));
+	const ContentFiltersManager::CheckResultsCacheStatistics coldStatistics(ContentFiltersManager::getCheckResultsCacheStatistics());
+	QVector<qint64> warmLatencies;
+	warmLatencies.reserve(requests.count() * (iterations - 1));
+
+	for (int i = 1; i < iterations; ++i)
+	{
+		warmLatencies.append(replayRequests(profiles, requests, canUseThreads, blockedAmount));
+	}
+
+	const qint64 replayTime(timer.nsecsElapsed());
+	const ContentFiltersManager::CheckResultsCacheStatistics warmStatistics(ContentFiltersManager::getCheckResultsCacheStatistics());
+
+	for (int i = 0; i < lists.count(); ++i)
+	{
+		const ListInformation &information(lists.at(i));
+
+		output << QFileInfo(information.path).fileName() << ": " << information.rulesAmount << " rules, parsed in " << QString::number((information.parseTime / 1000000.0), 'f', 2) << " ms";
+
+		if (information.hasCache)
+		{
+			output << ", cache loaded in " << QString::number((information.cacheLoadTime / 1000000.0), 'f', 2) << " ms";
+		}
+
+		output << Qt::endl;
+	}
+
+	output << "Requests: " << requestsAmount << " (" << blockedAmount << " blocked, " << (canUseThreads ? "threaded" : "single thread") << ")" << Qt::endl;
+	output << "Cold replay: p50 " << formatPercentile(coldLatencies, 50) << " us, p99 " << formatPercentile(coldLatencies, 99) << " us, decisions cache " << (coldStatistics.hits - initialStatistics.hits) << " hits, " << (coldStatistics.misses - initialStatistics.misses) << " misses" << Qt::endl;
+
+	if (!warmLatencies.isEmpty())
+	{
+		output << "Warm replays: p50 " << formatPercentile(warmLatencies, 50) << " us, p99 " << formatPercentile(warmLatencies, 99) << " us, decisions cache " << (warmStatistics.hits - coldStatistics.hits) << " hits, " << (warmStatistics.misses - coldStatistics.misses) << " misses" << Qt::endl;
+	}
+
+	output << "Throughput: " << QString::number((requestsAmount / (replayTime / 1000000000.0)), 'f', 0) << " requests/s" << Qt::endl;
+	output << "Peak RSS: " << (getPeakMemoryUsage() / 1024) << " KiB" << Qt::endl;
+
+	return 0;
+}
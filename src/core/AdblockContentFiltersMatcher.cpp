@@ -0,0 +1,1105 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2010 - 2014 David Rosca <nowrep@gmail.com>
+* Copyright (C) 2014 - 2017 Jan Bajer aka bajasoft <jbajer@gmail.com>
+* Copyright (C) 2015 - 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "AdblockContentFiltersMatcher.h"
+
+#include <QtCore/QSaveFile>
+
+#include <limits>
+
+namespace Otter
+{
+
+QHash<QString, AdblockContentFiltersMatcher::RuleOption> AdblockContentFiltersMatcher::m_options({{QLatin1String("third-party"), ThirdPartyOption}, {QLatin1String("stylesheet"), StyleSheetOption}, {QLatin1String("image"), ImageOption}, {QLatin1String("script"), ScriptOption}, {QLatin1String("object"), ObjectOption}, {QLatin1String("object-subrequest"), ObjectSubRequestOption}, {QLatin1String("object_subrequest"), ObjectSubRequestOption}, {QLatin1String("subdocument"), SubDocumentOption}, {QLatin1String("xmlhttprequest"), XmlHttpRequestOption}, {QLatin1String("websocket"), WebSocketOption}, {QLatin1String("popup"), PopupOption}, {QLatin1String("elemhide"), ElementHideOption}, {QLatin1String("generichide"), GenericHideOption}});
+QHash<NetworkManager::ResourceType, AdblockContentFiltersMatcher::RuleOption> AdblockContentFiltersMatcher::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
+QRegularExpression AdblockContentFiltersMatcher::m_domainExpression(QLatin1String("[:\?&/=]"));
+
+AdblockContentFiltersMatcher::AdblockContentFiltersMatcher() :
+	m_file(nullptr),
+	m_header(nullptr),
+	m_strings(nullptr),
+	m_ruleEntries(nullptr),
+	m_domains(nullptr),
+	m_tokens(nullptr),
+	m_tokenRules(nullptr),
+	m_unindexedRules(nullptr),
+	m_cosmeticFilterEntries(nullptr),
+	m_cosmeticDomainFilterBuckets(nullptr),
+	m_cosmeticDomainExceptionBuckets(nullptr),
+	m_cosmeticSelectors(nullptr)
+{
+}
+
+AdblockContentFiltersMatcher::~AdblockContentFiltersMatcher()
+{
+	clear();
+}
+
+int AdblockContentFiltersMatcher::addRule(const Rule &rule)
+{
+	m_rules.append(rule);
+
+	return (m_rules.count() - 1);
+}
+
+void AdblockContentFiltersMatcher::addRules(const AdblockContentFiltersMatcher &matcher, int profile)
+{
+	const int rulesAmount(matcher.getRulesAmount());
+
+	m_rules.reserve(m_rules.count() + rulesAmount);
+
+	for (int i = 0; i < rulesAmount; ++i)
+	{
+		Rule rule(matcher.getRule(i));
+		rule.profile = profile;
+
+		m_rules.append(rule);
+	}
+}
+
+int AdblockContentFiltersMatcher::addRuleLine(const QString &rule, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled)
+{
+	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
+	{
+		return -1;
+	}
+
+	if (rule.startsWith(QLatin1String("##")))
+	{
+		if (cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+		{
+			addCosmeticFilter(rule.mid(2));
+		}
+
+		return -1;
+	}
+
+	if (rule.contains(QLatin1String("##")))
+	{
+		if (cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		{
+			parseStyleSheetRule(rule.split(QLatin1String("##")), false);
+		}
+
+		return -1;
+	}
+
+	if (rule.contains(QLatin1String("#@#")))
+	{
+		if (cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		{
+			parseStyleSheetRule(rule.split(QLatin1String("#@#")), true);
+		}
+
+		return -1;
+	}
+
+	const int optionsSeparator(rule.indexOf(QLatin1Char('$')));
+	const QStringList options((optionsSeparator >= 0) ? rule.mid(optionsSeparator + 1).split(QLatin1Char(','), Qt::SkipEmptyParts) : QStringList());
+	QString line(rule);
+
+	if (optionsSeparator >= 0)
+	{
+		line = line.left(optionsSeparator);
+	}
+
+	if (line.endsWith(QLatin1Char('*')))
+	{
+		line = line.left(line.length() - 1);
+	}
+
+	if (line.startsWith(QLatin1Char('*')))
+	{
+		line = line.mid(1);
+	}
+
+	if (!areWildcardsEnabled && line.contains(QLatin1Char('*')))
+	{
+		return -1;
+	}
+
+	Rule definition;
+	definition.rule = rule;
+	definition.isException = line.startsWith(QLatin1String("@@"));
+
+	if (definition.isException)
+	{
+		line = line.mid(2);
+	}
+
+	definition.needsDomainCheck = line.startsWith(QLatin1String("||"));
+
+	if (definition.needsDomainCheck)
+	{
+		line = line.mid(2);
+	}
+
+	if (line.startsWith(QLatin1Char('|')))
+	{
+		definition.ruleMatch = StartMatch;
+
+		line = line.mid(1);
+	}
+
+	if (line.endsWith(QLatin1Char('|')))
+	{
+		definition.ruleMatch = ((definition.ruleMatch == StartMatch) ? ExactMatch : EndMatch);
+
+		line = line.left(line.length() - 1);
+	}
+
+	for (int i = 0; i < options.count(); ++i)
+	{
+		const QString option(options.at(i));
+		const bool isOptionException(option.startsWith(QLatin1Char('~')));
+		const QString optionName(isOptionException ? option.mid(1) : option);
+
+		if (m_options.contains(optionName))
+		{
+			const RuleOption ruleOption(m_options.value(optionName));
+
+			if ((!definition.isException || isOptionException) && (ruleOption == ElementHideOption || ruleOption == GenericHideOption))
+			{
+				continue;
+			}
+
+			if (!isOptionException)
+			{
+				definition.ruleOptions |= ruleOption;
+			}
+			else if (ruleOption != WebSocketOption && ruleOption != PopupOption)
+			{
+				definition.ruleExceptions |= ruleOption;
+			}
+		}
+		else if (optionName.startsWith(QLatin1String("domain")))
+		{
+			const QStringList parsedDomains(option.mid(option.indexOf(QLatin1Char('=')) + 1).split(QLatin1Char('|'), Qt::SkipEmptyParts));
+
+			for (int j = 0; j < parsedDomains.count(); ++j)
+			{
+				const QString parsedDomain(parsedDomains.at(j));
+
+				if (parsedDomain.startsWith(QLatin1Char('~')))
+				{
+					definition.allowedDomains.append(parsedDomain.mid(1));
+				}
+				else
+				{
+					definition.blockedDomains.append(parsedDomain);
+				}
+			}
+		}
+		else
+		{
+			return -1;
+		}
+	}
+
+	definition.pattern = line;
+
+	return addRule(definition);
+}
+
+void AdblockContentFiltersMatcher::parseStyleSheetRule(const QStringList &line, bool isException)
+{
+	const QStringList domains(line.at(0).split(QLatin1Char(',')));
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		if (isException)
+		{
+			addCosmeticDomainException(domains.at(i), line.at(1));
+		}
+		else
+		{
+			addCosmeticDomainFilter(domains.at(i), line.at(1));
+		}
+	}
+}
+
+void AdblockContentFiltersMatcher::addCosmeticFilter(const QString &rule)
+{
+	m_cosmeticFilters.append(rule);
+}
+
+void AdblockContentFiltersMatcher::addCosmeticDomainFilter(const QString &domain, const QString &rule)
+{
+	m_cosmeticDomainFilters[domain].append(rule);
+}
+
+void AdblockContentFiltersMatcher::addCosmeticDomainException(const QString &domain, const QString &rule)
+{
+	m_cosmeticDomainExceptions[domain].append(rule);
+}
+
+void AdblockContentFiltersMatcher::compile()
+{
+	QString strings;
+	QVector<RuleEntry> rules;
+	QVector<StringReference> domains;
+	QVector<quint32> unindexedRules;
+	QHash<quint64, QVector<quint32> > tokens;
+	QHash<QString, StringReference> domainReferences;
+
+	rules.reserve(m_rules.count());
+
+	for (int i = 0; i < m_rules.count(); ++i)
+	{
+		const Rule &rule(m_rules.at(i));
+		RuleEntry entry = RuleEntry();
+		entry.rule = appendString(strings, rule.rule);
+		entry.pattern = appendString(strings, rule.pattern);
+		entry.domainsOffset = static_cast<quint32>(domains.count());
+		entry.blockedDomainsAmount = static_cast<quint32>(rule.blockedDomains.count());
+		entry.allowedDomainsAmount = static_cast<quint32>(rule.allowedDomains.count());
+		entry.profile = rule.profile;
+		entry.ruleOptions = static_cast<quint16>(rule.ruleOptions);
+		entry.ruleExceptions = static_cast<quint16>(rule.ruleExceptions);
+		entry.ruleMatch = static_cast<quint8>(rule.ruleMatch);
+		entry.isException = rule.isException;
+		entry.needsDomainCheck = rule.needsDomainCheck;
+
+		for (int j = 0; j < rule.blockedDomains.count(); ++j)
+		{
+			domains.append(internString(strings, domainReferences, rule.blockedDomains.at(j)));
+		}
+
+		for (int j = 0; j < rule.allowedDomains.count(); ++j)
+		{
+			domains.append(internString(strings, domainReferences, rule.allowedDomains.at(j)));
+		}
+
+		rules.append(entry);
+
+		quint64 token(0);
+		int tokenRulesAmount(-1);
+
+		for (int j = 0; j < (rule.pattern.length() - 2); ++j)
+		{
+			const QChar *characters(rule.pattern.constData() + j);
+
+			if (!isTokenCharacter(characters[0]) || !isTokenCharacter(characters[1]) || !isTokenCharacter(characters[2]))
+			{
+				continue;
+			}
+
+			const quint64 currentToken(createToken(characters));
+			const QHash<quint64, QVector<quint32> >::const_iterator iterator(tokens.constFind(currentToken));
+			const int currentTokenRulesAmount((iterator == tokens.constEnd()) ? 0 : iterator.value().count());
+
+			if (tokenRulesAmount < 0 || currentTokenRulesAmount < tokenRulesAmount)
+			{
+				token = currentToken;
+				tokenRulesAmount = currentTokenRulesAmount;
+
+				if (tokenRulesAmount == 0)
+				{
+					break;
+				}
+			}
+		}
+
+		if (tokenRulesAmount < 0)
+		{
+			unindexedRules.append(static_cast<quint32>(i));
+		}
+		else
+		{
+			tokens[token].append(static_cast<quint32>(i));
+		}
+	}
+
+	QVector<TokenBucket> tokenBuckets;
+	QVector<quint32> tokenRules;
+
+	if (!tokens.isEmpty())
+	{
+		quint32 bucketsAmount(1);
+
+		while (bucketsAmount < static_cast<quint32>(tokens.count() * 2))
+		{
+			bucketsAmount *= 2;
+		}
+
+		tokenBuckets.fill(TokenBucket(), static_cast<int>(bucketsAmount));
+
+		QHash<quint64, QVector<quint32> >::const_iterator iterator;
+
+		for (iterator = tokens.constBegin(); iterator != tokens.constEnd(); ++iterator)
+		{
+			quint32 index(hashToken(iterator.key()) & (bucketsAmount - 1));
+
+			while (tokenBuckets.at(static_cast<int>(index)).amount > 0)
+			{
+				index = ((index + 1) & (bucketsAmount - 1));
+			}
+
+			TokenBucket &bucket(tokenBuckets[static_cast<int>(index)]);
+			bucket.token = iterator.key();
+			bucket.offset = static_cast<quint32>(tokenRules.count());
+			bucket.amount = static_cast<quint32>(iterator.value().count());
+
+			tokenRules.append(iterator.value());
+		}
+	}
+
+	QVector<StringReference> cosmeticFilters;
+	QVector<StringReference> cosmeticSelectors;
+
+	cosmeticFilters.reserve(m_cosmeticFilters.count());
+
+	for (int i = 0; i < m_cosmeticFilters.count(); ++i)
+	{
+		cosmeticFilters.append(appendString(strings, m_cosmeticFilters.at(i)));
+	}
+
+	const QVector<DomainBucket> cosmeticDomainFilters(createDomainBuckets(m_cosmeticDomainFilters, strings, domainReferences, cosmeticSelectors));
+	const QVector<DomainBucket> cosmeticDomainExceptions(createDomainBuckets(m_cosmeticDomainExceptions, strings, domainReferences, cosmeticSelectors));
+	Header header = Header();
+	header.magic = CacheMagic;
+	header.version = CacheVersion;
+
+	QByteArray image(static_cast<int>(sizeof(Header)), 0);
+
+	appendSection(image, header.strings, strings.constData(), static_cast<quint32>(strings.length()), sizeof(QChar));
+	appendSection(image, header.rules, rules.constData(), static_cast<quint32>(rules.count()), sizeof(RuleEntry));
+	appendSection(image, header.domains, domains.constData(), static_cast<quint32>(domains.count()), sizeof(StringReference));
+	appendSection(image, header.tokens, tokenBuckets.constData(), static_cast<quint32>(tokenBuckets.count()), sizeof(TokenBucket));
+	appendSection(image, header.tokenRules, tokenRules.constData(), static_cast<quint32>(tokenRules.count()), sizeof(quint32));
+	appendSection(image, header.unindexedRules, unindexedRules.constData(), static_cast<quint32>(unindexedRules.count()), sizeof(quint32));
+	appendSection(image, header.cosmeticFilters, cosmeticFilters.constData(), static_cast<quint32>(cosmeticFilters.count()), sizeof(StringReference));
+	appendSection(image, header.cosmeticDomainFilters, cosmeticDomainFilters.constData(), static_cast<quint32>(cosmeticDomainFilters.count()), sizeof(DomainBucket));
+	appendSection(image, header.cosmeticDomainExceptions, cosmeticDomainExceptions.constData(), static_cast<quint32>(cosmeticDomainExceptions.count()), sizeof(DomainBucket));
+	appendSection(image, header.cosmeticSelectors, cosmeticSelectors.constData(), static_cast<quint32>(cosmeticSelectors.count()), sizeof(StringReference));
+
+	header.size = static_cast<quint32>(image.size());
+
+	memcpy(image.data(), &header, sizeof(Header));
+
+	clear();
+	setImage(image);
+}
+
+void AdblockContentFiltersMatcher::clear()
+{
+	m_rules.clear();
+	m_rules.squeeze();
+	m_cosmeticFilters.clear();
+	m_cosmeticDomainFilters.clear();
+	m_cosmeticDomainExceptions.clear();
+	m_image.clear();
+
+	m_header = nullptr;
+
+	if (m_file)
+	{
+		delete m_file;
+
+		m_file = nullptr;
+	}
+}
+
+void AdblockContentFiltersMatcher::appendSection(QByteArray &image, Section &section, const void *data, quint32 amount, quint32 size)
+{
+	image.append(QByteArray(((8 - (image.size() % 8)) % 8), 0));
+
+	section.offset = static_cast<quint32>(image.size());
+	section.amount = amount;
+
+	if (amount > 0)
+	{
+		image.append(static_cast<const char*>(data), static_cast<int>(amount * size));
+	}
+}
+
+AdblockContentFiltersMatcher::Rule AdblockContentFiltersMatcher::getRule(int index) const
+{
+	if (!m_header)
+	{
+		return m_rules.value(index);
+	}
+
+	Rule rule;
+
+	if (index < 0 || static_cast<quint32>(index) >= m_header->rules.amount)
+	{
+		return rule;
+	}
+
+	const RuleEntry &entry(m_ruleEntries[index]);
+
+	rule.rule = getString(entry.rule).toString();
+	rule.pattern = getString(entry.pattern).toString();
+	rule.ruleOptions = RuleOptions(QFlag(entry.ruleOptions));
+	rule.ruleExceptions = RuleOptions(QFlag(entry.ruleExceptions));
+	rule.ruleMatch = static_cast<RuleMatch>(entry.ruleMatch);
+	rule.profile = entry.profile;
+	rule.isException = (entry.isException != 0);
+	rule.needsDomainCheck = (entry.needsDomainCheck != 0);
+
+	if ((static_cast<quint64>(entry.domainsOffset) + entry.blockedDomainsAmount + entry.allowedDomainsAmount) <= m_header->domains.amount)
+	{
+		for (quint32 i = 0; i < entry.blockedDomainsAmount; ++i)
+		{
+			rule.blockedDomains.append(getString(m_domains[entry.domainsOffset + i]).toString());
+		}
+
+		for (quint32 i = 0; i < entry.allowedDomainsAmount; ++i)
+		{
+			rule.allowedDomains.append(getString(m_domains[entry.domainsOffset + entry.blockedDomainsAmount + i]).toString());
+		}
+	}
+
+	return rule;
+}
+
+QHash<QStringView, int> AdblockContentFiltersMatcher::getRuleIndexes() const
+{
+	QHash<QStringView, int> indexes;
+
+	if (!m_header)
+	{
+		return indexes;
+	}
+
+	indexes.reserve(static_cast<int>(m_header->rules.amount));
+
+	for (quint32 i = 0; i < m_header->rules.amount; ++i)
+	{
+		indexes.insert(getString(m_ruleEntries[i].rule), static_cast<int>(i));
+	}
+
+	return indexes;
+}
+
+QStringView AdblockContentFiltersMatcher::getString(const StringReference &reference) const
+{
+	if ((static_cast<quint64>(reference.offset) + reference.length) > m_header->strings.amount)
+	{
+		return {};
+	}
+
+	return QStringView((m_strings + reference.offset), static_cast<qsizetype>(reference.length));
+}
+
+QStringList AdblockContentFiltersMatcher::getCosmeticFilters() const
+{
+	QStringList filters;
+
+	if (!m_header)
+	{
+		return filters;
+	}
+
+	filters.reserve(static_cast<int>(m_header->cosmeticFilters.amount));
+
+	for (quint32 i = 0; i < m_header->cosmeticFilters.amount; ++i)
+	{
+		filters.append(getString(m_cosmeticFilterEntries[i]).toString());
+	}
+
+	return filters;
+}
+
+QStringList AdblockContentFiltersMatcher::getCosmeticDomainFilters(const QString &domain) const
+{
+	return (m_header ? getCosmeticSelectors(m_cosmeticDomainFilterBuckets, m_header->cosmeticDomainFilters.amount, domain) : QStringList());
+}
+
+QStringList AdblockContentFiltersMatcher::getCosmeticDomainExceptions(const QString &domain) const
+{
+	return (m_header ? getCosmeticSelectors(m_cosmeticDomainExceptionBuckets, m_header->cosmeticDomainExceptions.amount, domain) : QStringList());
+}
+
+QStringList AdblockContentFiltersMatcher::getCosmeticSelectors(const DomainBucket *buckets, quint32 bucketsAmount, const QString &domain) const
+{
+	QStringList selectors;
+
+	if (bucketsAmount == 0)
+	{
+		return selectors;
+	}
+
+	quint32 index(hashString(QStringView(domain)) & (bucketsAmount - 1));
+
+	for (quint32 i = 0; i < bucketsAmount; ++i)
+	{
+		const DomainBucket &bucket(buckets[index]);
+
+		if (bucket.amount == 0)
+		{
+			break;
+		}
+
+		if (getString(bucket.domain) == QStringView(domain))
+		{
+			if ((static_cast<quint64>(bucket.offset) + bucket.amount) <= m_header->cosmeticSelectors.amount)
+			{
+				selectors.reserve(static_cast<int>(bucket.amount));
+
+				for (quint32 j = 0; j < bucket.amount; ++j)
+				{
+					selectors.append(getString(m_cosmeticSelectors[bucket.offset + j]).toString());
+				}
+			}
+
+			break;
+		}
+
+		index = ((index + 1) & (bucketsAmount - 1));
+	}
+
+	return selectors;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersMatcher::checkUrl(const Request &request) const
+{
+	if (!m_header)
+	{
+		return {};
+	}
+
+	QVarLengthArray<quint32, 64> candidates;
+	candidates.append(m_unindexedRules, static_cast<int>(m_header->unindexedRules.amount));
+
+	if (m_header->tokens.amount > 0)
+	{
+		const quint32 mask(m_header->tokens.amount - 1);
+
+		for (int i = 0; i < (request.requestUrl.length() - 2); ++i)
+		{
+			const quint64 token(createToken(request.requestUrl.constData() + i));
+			quint32 index(hashToken(token) & mask);
+
+			for (quint32 j = 0; j < m_header->tokens.amount; ++j)
+			{
+				const TokenBucket &bucket(m_tokens[index]);
+
+				if (bucket.amount == 0)
+				{
+					break;
+				}
+
+				if (bucket.token == token)
+				{
+					if ((static_cast<quint64>(bucket.offset) + bucket.amount) <= m_header->tokenRules.amount)
+					{
+						candidates.append((m_tokenRules + bucket.offset), static_cast<int>(bucket.amount));
+					}
+
+					break;
+				}
+
+				index = ((index + 1) & mask);
+			}
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	ContentFiltersManager::CheckResult result;
+
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		const quint32 index(candidates.at(i));
+
+		if ((i > 0 && index == candidates.at(i - 1)) || index >= m_header->rules.amount)
+		{
+			continue;
+		}
+
+		const ContentFiltersManager::CheckResult currentResult(checkRule(m_ruleEntries[index], request));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersMatcher::checkRule(const RuleEntry &rule, const Request &request) const
+{
+	ContentFiltersManager::CheckResult result;
+	const QStringView pattern(getString(rule.pattern));
+	const int length((rule.ruleMatch == StartMatch || rule.ruleMatch == ExactMatch) ? qMin(1, request.requestUrl.length()) : request.requestUrl.length());
+
+	for (int i = 0; i < length; ++i)
+	{
+		const ContentFiltersManager::CheckResult currentResult(checkPattern(rule, pattern, 0, i, i, request));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersMatcher::checkPattern(const RuleEntry &rule, const QStringView &pattern, int patternPosition, int urlPosition, int startPosition, const Request &request) const
+{
+	const QString &url(request.requestUrl);
+
+	while (patternPosition < pattern.size())
+	{
+		const QChar character(pattern.at(patternPosition));
+
+		if (character == QLatin1Char('*'))
+		{
+			ContentFiltersManager::CheckResult result;
+
+			for (int i = urlPosition; i < url.length(); ++i)
+			{
+				const ContentFiltersManager::CheckResult currentResult(checkPattern(rule, pattern, (patternPosition + 1), i, startPosition, request));
+
+				if (currentResult.isBlocked)
+				{
+					result = currentResult;
+				}
+				else if (currentResult.isException)
+				{
+					return currentResult;
+				}
+			}
+
+			return result;
+		}
+
+		if (urlPosition >= url.length())
+		{
+			return {};
+		}
+
+		if (character == QLatin1Char('^'))
+		{
+			if (!isSeparator(url.at(urlPosition)))
+			{
+				return {};
+			}
+
+			++patternPosition;
+
+			continue;
+		}
+
+		if (url.at(urlPosition) != character)
+		{
+			return {};
+		}
+
+		++patternPosition;
+		++urlPosition;
+	}
+
+	return checkRuleMatch(rule, url.mid(startPosition, (urlPosition - startPosition)), request);
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersMatcher::checkRuleMatch(int index, const QString &currentRule, const Request &request) const
+{
+	if (!m_header || index < 0 || static_cast<quint32>(index) >= m_header->rules.amount)
+	{
+		return {};
+	}
+
+	return checkRuleMatch(m_ruleEntries[index], currentRule, request);
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersMatcher::checkRuleMatch(const RuleEntry &rule, const QString &currentRule, const Request &request) const
+{
+	switch (rule.ruleMatch)
+	{
+		case StartMatch:
+			if (!request.requestUrl.startsWith(currentRule))
+			{
+				return {};
+			}
+
+			break;
+		case EndMatch:
+			if (!request.requestUrl.endsWith(currentRule))
+			{
+				return {};
+			}
+
+			break;
+		case ExactMatch:
+			if (request.requestUrl != currentRule)
+			{
+				return {};
+			}
+
+			break;
+		default:
+			if (!request.requestUrl.contains(currentRule))
+			{
+				return {};
+			}
+
+			break;
+	}
+
+	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
+
+	if (rule.needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
+	{
+		return {};
+	}
+
+	const RuleOptions ruleOptions(QFlag(rule.ruleOptions));
+	const RuleOptions ruleExceptions(QFlag(rule.ruleExceptions));
+	const bool hasBlockedDomains(rule.blockedDomainsAmount > 0);
+	const bool hasAllowedDomains(rule.allowedDomainsAmount > 0);
+	bool isBlocked(true);
+
+	if (hasBlockedDomains)
+	{
+		isBlocked = resolveDomainExceptions(request.baseHost, rule.domainsOffset, rule.blockedDomainsAmount);
+
+		if (!isBlocked)
+		{
+			return {};
+		}
+	}
+
+	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, (rule.domainsOffset + rule.blockedDomainsAmount), rule.allowedDomainsAmount) : isBlocked);
+
+	if (ruleOptions.testFlag(ThirdPartyOption) || ruleExceptions.testFlag(ThirdPartyOption))
+	{
+		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
+		{
+			isBlocked = ruleExceptions.testFlag(ThirdPartyOption);
+		}
+		else if (!hasBlockedDomains && !hasAllowedDomains)
+		{
+			isBlocked = ruleOptions.testFlag(ThirdPartyOption);
+		}
+	}
+
+	if (ruleOptions != NoOption || ruleExceptions != NoOption)
+	{
+		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
+
+		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
+		{
+			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
+
+			if (!ruleOptions.testFlag(iterator.value()) && !(supportsException && ruleExceptions.testFlag(iterator.value())))
+			{
+				continue;
+			}
+
+			if (request.resourceType == iterator.key())
+			{
+				isBlocked = (isBlocked ? ruleOptions.testFlag(iterator.value()) : isBlocked);
+			}
+			else if (supportsException)
+			{
+				isBlocked = (isBlocked ? ruleExceptions.testFlag(iterator.value()) : isBlocked);
+			}
+			else
+			{
+				isBlocked = false;
+			}
+		}
+	}
+	else if (request.resourceType == NetworkManager::PopupType)
+	{
+		isBlocked = false;
+	}
+
+	if (!isBlocked)
+	{
+		return {};
+	}
+
+	ContentFiltersManager::CheckResult result;
+	result.rule = getString(rule.rule).toString();
+	result.profile = rule.profile;
+
+	if (rule.isException)
+	{
+		result.isBlocked = false;
+		result.isException = true;
+
+		if (ruleOptions.testFlag(ElementHideOption))
+		{
+			result.comesticFiltersMode = ContentFiltersManager::NoFilters;
+		}
+		else if (ruleOptions.testFlag(GenericHideOption))
+		{
+			result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
+		}
+
+		return result;
+	}
+
+	result.isBlocked = true;
+
+	return result;
+}
+
+AdblockContentFiltersMatcher::StringReference AdblockContentFiltersMatcher::appendString(QString &strings, const QString &string)
+{
+	StringReference reference;
+	reference.offset = static_cast<quint32>(strings.length());
+	reference.length = static_cast<quint32>(string.length());
+
+	strings.append(string);
+
+	return reference;
+}
+
+AdblockContentFiltersMatcher::StringReference AdblockContentFiltersMatcher::internString(QString &strings, QHash<QString, StringReference> &references, const QString &string)
+{
+	const QHash<QString, StringReference>::const_iterator iterator(references.constFind(string));
+
+	if (iterator != references.constEnd())
+	{
+		return iterator.value();
+	}
+
+	const StringReference reference(appendString(strings, string));
+
+	references.insert(string, reference);
+
+	return reference;
+}
+
+QVector<AdblockContentFiltersMatcher::DomainBucket> AdblockContentFiltersMatcher::createDomainBuckets(const QHash<QString, QStringList> &filters, QString &strings, QHash<QString, StringReference> &references, QVector<StringReference> &selectors)
+{
+	QVector<DomainBucket> buckets;
+
+	if (filters.isEmpty())
+	{
+		return buckets;
+	}
+
+	quint32 bucketsAmount(1);
+
+	while (bucketsAmount < static_cast<quint32>(filters.count() * 2))
+	{
+		bucketsAmount *= 2;
+	}
+
+	buckets.fill(DomainBucket(), static_cast<int>(bucketsAmount));
+
+	QHash<QString, QStringList>::const_iterator iterator;
+
+	for (iterator = filters.constBegin(); iterator != filters.constEnd(); ++iterator)
+	{
+		quint32 index(hashString(QStringView(iterator.key())) & (bucketsAmount - 1));
+
+		while (buckets.at(static_cast<int>(index)).amount > 0)
+		{
+			index = ((index + 1) & (bucketsAmount - 1));
+		}
+
+		DomainBucket &bucket(buckets[static_cast<int>(index)]);
+		bucket.domain = internString(strings, references, iterator.key());
+		bucket.offset = static_cast<quint32>(selectors.count());
+		bucket.amount = static_cast<quint32>(iterator.value().count());
+
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			selectors.append(appendString(strings, iterator.value().at(i)));
+		}
+	}
+
+	return buckets;
+}
+
+quint64 AdblockContentFiltersMatcher::createToken(const QChar *characters)
+{
+	return ((static_cast<quint64>(characters[0].unicode()) << 32) | (static_cast<quint64>(characters[1].unicode()) << 16) | static_cast<quint64>(characters[2].unicode()));
+}
+
+quint32 AdblockContentFiltersMatcher::hashToken(quint64 token)
+{
+	return static_cast<quint32>((token * Q_UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+quint32 AdblockContentFiltersMatcher::hashString(const QStringView &string)
+{
+	quint32 hash(2166136261U);
+
+	for (qsizetype i = 0; i < string.size(); ++i)
+	{
+		hash ^= string.at(i).unicode();
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+int AdblockContentFiltersMatcher::getRulesAmount() const
+{
+	return (m_header ? static_cast<int>(m_header->rules.amount) : m_rules.count());
+}
+
+bool AdblockContentFiltersMatcher::load(const QString &path, const QByteArray &checksum, quint32 settings)
+{
+	clear();
+
+	QFile *file(new QFile(path));
+
+	if (!file->open(QIODevice::ReadOnly) || file->size() < static_cast<qint64>(sizeof(Header)) || file->size() > std::numeric_limits<int>::max())
+	{
+		delete file;
+
+		return false;
+	}
+
+	const uchar *data(file->map(0, file->size()));
+
+	if (!data)
+	{
+		delete file;
+
+		return false;
+	}
+
+	const Header *header(reinterpret_cast<const Header*>(data));
+
+	if (header->settings != settings || checksum.size() != static_cast<int>(sizeof(header->checksum)) || memcmp(header->checksum, checksum.constData(), sizeof(header->checksum)) != 0 || !setImage(QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(file->size()))))
+	{
+		delete file;
+
+		return false;
+	}
+
+	m_file = file;
+
+	return true;
+}
+
+bool AdblockContentFiltersMatcher::save(const QString &path, const QByteArray &checksum, quint32 settings) const
+{
+	if (!m_header || checksum.size() != static_cast<int>(sizeof(m_header->checksum)))
+	{
+		return false;
+	}
+
+	Header header(*m_header);
+	header.settings = settings;
+
+	memcpy(header.checksum, checksum.constData(), sizeof(header.checksum));
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write((m_image.constData() + sizeof(Header)), (m_image.size() - static_cast<int>(sizeof(Header))));
+
+	return file.commit();
+}
+
+bool AdblockContentFiltersMatcher::setImage(const QByteArray &image)
+{
+	if (image.size() < static_cast<int>(sizeof(Header)))
+	{
+		return false;
+	}
+
+	const Header *header(reinterpret_cast<const Header*>(image.constData()));
+
+	if (header->magic != CacheMagic || header->version != CacheVersion || header->size != static_cast<quint32>(image.size()))
+	{
+		return false;
+	}
+
+	if (!isSectionValid(image, header->strings, sizeof(QChar)) || !isSectionValid(image, header->rules, sizeof(RuleEntry)) || !isSectionValid(image, header->domains, sizeof(StringReference)) || !isSectionValid(image, header->tokens, sizeof(TokenBucket)) || !isSectionValid(image, header->tokenRules, sizeof(quint32)) || !isSectionValid(image, header->unindexedRules, sizeof(quint32)) || !isSectionValid(image, header->cosmeticFilters, sizeof(StringReference)) || !isSectionValid(image, header->cosmeticDomainFilters, sizeof(DomainBucket)) || !isSectionValid(image, header->cosmeticDomainExceptions, sizeof(DomainBucket)) || !isSectionValid(image, header->cosmeticSelectors, sizeof(StringReference)))
+	{
+		return false;
+	}
+
+	if ((header->tokens.amount & (header->tokens.amount - 1)) != 0 || (header->cosmeticDomainFilters.amount & (header->cosmeticDomainFilters.amount - 1)) != 0 || (header->cosmeticDomainExceptions.amount & (header->cosmeticDomainExceptions.amount - 1)) != 0)
+	{
+		return false;
+	}
+
+	m_image = image;
+
+	const char *data(m_image.constData());
+
+	m_header = reinterpret_cast<const Header*>(data);
+	m_strings = reinterpret_cast<const QChar*>(data + m_header->strings.offset);
+	m_ruleEntries = reinterpret_cast<const RuleEntry*>(data + m_header->rules.offset);
+	m_domains = reinterpret_cast<const StringReference*>(data + m_header->domains.offset);
+	m_tokens = reinterpret_cast<const TokenBucket*>(data + m_header->tokens.offset);
+	m_tokenRules = reinterpret_cast<const quint32*>(data + m_header->tokenRules.offset);
+	m_unindexedRules = reinterpret_cast<const quint32*>(data + m_header->unindexedRules.offset);
+	m_cosmeticFilterEntries = reinterpret_cast<const StringReference*>(data + m_header->cosmeticFilters.offset);
+	m_cosmeticDomainFilterBuckets = reinterpret_cast<const DomainBucket*>(data + m_header->cosmeticDomainFilters.offset);
+	m_cosmeticDomainExceptionBuckets = reinterpret_cast<const DomainBucket*>(data + m_header->cosmeticDomainExceptions.offset);
+	m_cosmeticSelectors = reinterpret_cast<const StringReference*>(data + m_header->cosmeticSelectors.offset);
+
+	return true;
+}
+
+bool AdblockContentFiltersMatcher::resolveDomainExceptions(const QString &url, quint32 offset, quint32 amount) const
+{
+	if ((static_cast<quint64>(offset) + amount) > m_header->domains.amount)
+	{
+		return false;
+	}
+
+	for (quint32 i = offset; i < (offset + amount); ++i)
+	{
+		if (url.contains(getString(m_domains[i])))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AdblockContentFiltersMatcher::isSectionValid(const QByteArray &image, const Section &section, quint32 size)
+{
+	return ((section.offset % 8) == 0 && section.offset >= sizeof(Header) && (static_cast<quint64>(section.offset) + (static_cast<quint64>(section.amount) * size)) <= static_cast<quint64>(image.size()));
+}
+
+bool AdblockContentFiltersMatcher::isSeparator(const QChar &character)
+{
+	return (!character.isDigit() && !character.isLetter() && character != QLatin1Char('_') && character != QLatin1Char('-') && character != QLatin1Char('.') && character != QLatin1Char('%'));
+}
+
+bool AdblockContentFiltersMatcher::isTokenCharacter(const QChar &character)
+{
+	return (character != QLatin1Char('*') && character != QLatin1Char('^'));
+}
+
+}
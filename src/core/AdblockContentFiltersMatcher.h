@@ -0,0 +1,231 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2010 - 2014 David Rosca <nowrep@gmail.com>
+* Copyright (C) 2014 - 2017 Jan Bajer aka bajasoft <jbajer@gmail.com>
+* Copyright (C) 2015 - 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_ADBLOCKCONTENTFILTERSMATCHER_H
+#define OTTER_ADBLOCKCONTENTFILTERSMATCHER_H
+
+#include "ContentFiltersManager.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+
+namespace Otter
+{
+
+class AdblockContentFiltersMatcher final
+{
+public:
+	enum RuleOption : quint16
+	{
+		NoOption = 0,
+		ThirdPartyOption = 1,
+		StyleSheetOption = 2,
+		ScriptOption = 4,
+		ImageOption = 8,
+		ObjectOption = 16,
+		ObjectSubRequestOption = 32,
+		SubDocumentOption = 64,
+		XmlHttpRequestOption = 128,
+		WebSocketOption = 256,
+		PopupOption = 512,
+		ElementHideOption = 1024,
+		GenericHideOption = 2048
+	};
+
+	Q_DECLARE_FLAGS(RuleOptions, RuleOption)
+
+	enum RuleMatch
+	{
+		ContainsMatch = 0,
+		StartMatch,
+		EndMatch,
+		ExactMatch
+	};
+
+	struct Rule final
+	{
+		QString rule;
+		QString pattern;
+		QStringList blockedDomains;
+		QStringList allowedDomains;
+		RuleOptions ruleOptions = NoOption;
+		RuleOptions ruleExceptions = NoOption;
+		RuleMatch ruleMatch = ContainsMatch;
+		int profile = -1;
+		bool isException = false;
+		bool needsDomainCheck = false;
+	};
+
+	struct Request final
+	{
+		QString baseHost;
+		QString requestHost;
+		QString requestUrl;
+		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+
+		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), resourceType(resourceTypeValue)
+		{
+			if (requestUrl.startsWith(QLatin1String("//")))
+			{
+				requestUrl = requestUrl.mid(2);
+			}
+		}
+	};
+
+	explicit AdblockContentFiltersMatcher();
+	~AdblockContentFiltersMatcher();
+
+	int addRule(const Rule &rule);
+	int addRuleLine(const QString &rule, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled);
+	void addRules(const AdblockContentFiltersMatcher &matcher, int profile);
+	void addCosmeticFilter(const QString &rule);
+	void addCosmeticDomainFilter(const QString &domain, const QString &rule);
+	void addCosmeticDomainException(const QString &domain, const QString &rule);
+	void compile();
+	void clear();
+	Rule getRule(int index) const;
+	QHash<QStringView, int> getRuleIndexes() const;
+	QStringList getCosmeticFilters() const;
+	QStringList getCosmeticDomainFilters(const QString &domain) const;
+	QStringList getCosmeticDomainExceptions(const QString &domain) const;
+	ContentFiltersManager::CheckResult checkUrl(const Request &request) const;
+	ContentFiltersManager::CheckResult checkRuleMatch(int index, const QString &currentRule, const Request &request) const;
+	int getRulesAmount() const;
+	bool load(const QString &path, const QByteArray &checksum, quint32 settings);
+	bool save(const QString &path, const QByteArray &checksum, quint32 settings) const;
+	static bool isSeparator(const QChar &character);
+
+protected:
+	enum CacheInformation : quint32
+	{
+		CacheMagic = 0x4F434642,
+		CacheVersion = 2
+	};
+
+	struct Section final
+	{
+		quint32 offset;
+		quint32 amount;
+	};
+
+	struct StringReference final
+	{
+		quint32 offset;
+		quint32 length;
+	};
+
+	struct Header final
+	{
+		quint32 magic;
+		quint32 version;
+		quint32 settings;
+		quint32 size;
+		quint8 checksum[20];
+		quint32 reserved;
+		Section strings;
+		Section rules;
+		Section domains;
+		Section tokens;
+		Section tokenRules;
+		Section unindexedRules;
+		Section cosmeticFilters;
+		Section cosmeticDomainFilters;
+		Section cosmeticDomainExceptions;
+		Section cosmeticSelectors;
+	};
+
+	struct RuleEntry final
+	{
+		StringReference rule;
+		StringReference pattern;
+		quint32 domainsOffset;
+		quint32 blockedDomainsAmount;
+		quint32 allowedDomainsAmount;
+		qint32 profile;
+		quint16 ruleOptions;
+		quint16 ruleExceptions;
+		quint8 ruleMatch;
+		quint8 isException;
+		quint8 needsDomainCheck;
+		quint8 reserved;
+	};
+
+	struct TokenBucket final
+	{
+		quint64 token;
+		quint32 offset;
+		quint32 amount;
+	};
+
+	struct DomainBucket final
+	{
+		StringReference domain;
+		quint32 offset;
+		quint32 amount;
+	};
+
+	void parseStyleSheetRule(const QStringList &line, bool isException);
+	QStringView getString(const StringReference &reference) const;
+	QStringList getCosmeticSelectors(const DomainBucket *buckets, quint32 bucketsAmount, const QString &domain) const;
+	ContentFiltersManager::CheckResult checkRule(const RuleEntry &rule, const Request &request) const;
+	ContentFiltersManager::CheckResult checkPattern(const RuleEntry &rule, const QStringView &pattern, int patternPosition, int urlPosition, int startPosition, const Request &request) const;
+	ContentFiltersManager::CheckResult checkRuleMatch(const RuleEntry &rule, const QString &currentRule, const Request &request) const;
+	static StringReference appendString(QString &strings, const QString &string);
+	static StringReference internString(QString &strings, QHash<QString, StringReference> &references, const QString &string);
+	static QVector<DomainBucket> createDomainBuckets(const QHash<QString, QStringList> &filters, QString &strings, QHash<QString, StringReference> &references, QVector<StringReference> &selectors);
+	static void appendSection(QByteArray &image, Section &section, const void *data, quint32 amount, quint32 size);
+	static quint64 createToken(const QChar *characters);
+	static quint32 hashToken(quint64 token);
+	static quint32 hashString(const QStringView &string);
+	bool resolveDomainExceptions(const QString &url, quint32 offset, quint32 amount) const;
+	bool setImage(const QByteArray &image);
+	static bool isSectionValid(const QByteArray &image, const Section &section, quint32 size);
+	static bool isTokenCharacter(const QChar &character);
+
+private:
+	QFile *m_file;
+	QByteArray m_image;
+	QVector<Rule> m_rules;
+	QStringList m_cosmeticFilters;
+	QHash<QString, QStringList> m_cosmeticDomainFilters;
+	QHash<QString, QStringList> m_cosmeticDomainExceptions;
+	const Header *m_header;
+	const QChar *m_strings;
+	const RuleEntry *m_ruleEntries;
+	const StringReference *m_domains;
+	const TokenBucket *m_tokens;
+	const quint32 *m_tokenRules;
+	const quint32 *m_unindexedRules;
+	const StringReference *m_cosmeticFilterEntries;
+	const DomainBucket *m_cosmeticDomainFilterBuckets;
+	const DomainBucket *m_cosmeticDomainExceptionBuckets;
+	const StringReference *m_cosmeticSelectors;
+
+	static QHash<QString, RuleOption> m_options;
+	static QHash<NetworkManager::ResourceType, RuleOption> m_resourceTypes;
+	static QRegularExpression m_domainExpression;
+
+	Q_DISABLE_COPY(AdblockContentFiltersMatcher)
+};
+
+}
+
+#endif
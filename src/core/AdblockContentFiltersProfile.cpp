@@ -23,12 +23,16 @@
 #include "Console.h"
 #include "Job.h"
 #include "SessionsManager.h"
+#include "SettingsManager.h"
 #include "../ui/ContentBlockingProfileDialog.h"
 
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
 #include <QtWidgets/QApplication>
@@ -37,16 +41,13 @@
 namespace Otter
 {
 
-QHash<QString, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_options({{QLatin1String("third-party"), ThirdPartyOption}, {QLatin1String("stylesheet"), StyleSheetOption}, {QLatin1String("image"), ImageOption}, {QLatin1String("script"), ScriptOption}, {QLatin1String("object"), ObjectOption}, {QLatin1String("object-subrequest"), ObjectSubRequestOption}, {QLatin1String("object_subrequest"), ObjectSubRequestOption}, {QLatin1String("subdocument"), SubDocumentOption}, {QLatin1String("xmlhttprequest"), XmlHttpRequestOption}, {QLatin1String("websocket"), WebSocketOption}, {QLatin1String("popup"), PopupOption}, {QLatin1String("elemhide"), ElementHideOption}, {QLatin1String("generichide"), GenericHideOption}});
-QHash<NetworkManager::ResourceType, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
-
 AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &languages, ContentFiltersProfile::ProfileFlags flags, QObject *parent) : ContentFiltersProfile(parent),
-	m_root(nullptr),
 	m_dataFetchJob(nullptr),
 	m_profileSummary(profileSummary),
+	m_isLoading(0),
 	m_error(NoError),
 	m_flags(flags),
-	m_wasLoaded(false)
+	m_generation(0)
 {
 	if (!languages.isEmpty())
 	{
@@ -73,21 +74,43 @@ AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersP
 
 void AdblockContentFiltersProfile::clear()
 {
-	if (!m_wasLoaded)
+	QWriteLocker locker(&m_snapshotLock);
+
+	if (m_snapshot || !m_loadingFuture.isCanceled())
 	{
-		return;
+		startLoading(true);
 	}
+}
 
-	if (m_root)
+void AdblockContentFiltersProfile::load()
+{
 	{
-		QtConcurrent::run(this, &AdblockContentFiltersProfile::deleteNode, m_root);
+		QReadLocker locker(&m_snapshotLock);
+
+		if (m_snapshot)
+		{
+			return;
+		}
 	}
 
-	m_cosmeticFiltersRules.clear();
-	m_cosmeticFiltersDomainExceptions.clear();
-	m_cosmeticFiltersDomainRules.clear();
+	if (!m_isLoading.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
 
-	m_wasLoaded = false;
+	QMetaObject::invokeMethod(this, [=]()
+	{
+		{
+			QReadLocker locker(&m_snapshotLock);
+
+			if (m_snapshot || !m_loadingFuture.isCanceled())
+			{
+				return;
+			}
+		}
+
+		loadRules(true);
+	}, Qt::QueuedConnection);
 }
 
 void AdblockContentFiltersProfile::loadHeader()
@@ -130,213 +153,276 @@ void AdblockContentFiltersProfile::loadHeader()
 	}
 }
 
-void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
+void AdblockContentFiltersProfile::loadRules(bool canReplace)
 {
-	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
-	{
-		return;
-	}
+	const QString path(getPath());
+
+	m_error = NoError;
 
-	if (rule.startsWith(QLatin1String("##")))
+	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
 	{
-		if (m_profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+		if (!m_dataFetchJob && !update())
 		{
-			m_cosmeticFiltersRules.append(rule.mid(2));
+			m_isLoading.storeRelease(0);
 		}
 
 		return;
 	}
 
-	if (rule.contains(QLatin1String("##")))
+	QWriteLocker locker(&m_snapshotLock);
+
+	startLoading(canReplace);
+}
+
+void AdblockContentFiltersProfile::startLoading(bool canReplace)
+{
+	const QString path(getPath());
+	const QString cachePath(getCachePath());
+	const ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode(m_profileSummary.cosmeticFiltersMode);
+	const MatcherMode matcherMode(getMatcherMode());
+	const bool areWildcardsEnabled(m_profileSummary.areWildcardsEnabled);
+	const bool canSaveCache(!SessionsManager::isReadOnly());
+	const QSharedPointer<Snapshot> previousSnapshot(canReplace ? m_snapshot : QSharedPointer<Snapshot>());
+	const QFuture<QSharedPointer<Snapshot> > future(QtConcurrent::run([=]() -> QSharedPointer<Snapshot>
+	{
+		return createSnapshot(path, cachePath, cosmeticFiltersMode, areWildcardsEnabled, matcherMode, canSaveCache, previousSnapshot);
+	}));
+	int generation(-1);
+
+	if (canReplace)
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
-		{
-			parseStyleSheetRule(rule.split(QLatin1String("##")), m_cosmeticFiltersDomainRules);
-		}
+		generation = ++m_generation;
 
-		return;
+		m_loadingFuture = future;
+		m_isLoading.storeRelease(1);
 	}
 
-	if (rule.contains(QLatin1String("#@#")))
+	QMetaObject::invokeMethod(this, [=]()
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		QFutureWatcher<QSharedPointer<Snapshot> > *watcher(new QFutureWatcher<QSharedPointer<Snapshot> >(this));
+
+		connect(watcher, &QFutureWatcher<QSharedPointer<Snapshot> >::finished, this, [=]()
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("#@#")), m_cosmeticFiltersDomainExceptions);
-		}
+			const QSharedPointer<Snapshot> snapshot(watcher->result());
 
-		return;
-	}
+			watcher->deleteLater();
 
-	const int optionsSeparator(rule.indexOf(QLatin1Char('$')));
-	const QStringList options((optionsSeparator >= 0) ? rule.mid(optionsSeparator + 1).split(QLatin1Char(','), Qt::SkipEmptyParts) : QStringList());
-	QString line(rule);
+			if (snapshot->hasCacheError)
+			{
+				Console::addMessage(QCoreApplication::translate("main", "Failed to save content blocking profile cache"), Console::OtherCategory, Console::WarningLevel, cachePath);
+			}
 
-	if (optionsSeparator >= 0)
-	{
-		line = line.left(optionsSeparator);
-	}
+			if (canReplace)
+			{
+				replaceSnapshot(snapshot, generation);
+			}
+		});
 
-	if (line.endsWith(QLatin1Char('*')))
-	{
-		line = line.left(line.length() - 1);
-	}
+		watcher->setFuture(future);
+	}, Qt::QueuedConnection);
+}
 
-	if (line.startsWith(QLatin1Char('*')))
-	{
-		line = line.mid(1);
-	}
+void AdblockContentFiltersProfile::replaceSnapshot(const QSharedPointer<Snapshot> &snapshot, int generation)
+{
+	QSharedPointer<Snapshot> previousSnapshot;
 
-	if (!m_profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
 	{
-		return;
-	}
+		QWriteLocker locker(&m_snapshotLock);
+
+		if (generation != m_generation)
+		{
+			return;
+		}
 
-	Node::Rule *definition(new Node::Rule());
-	definition->rule = rule;
-	definition->isException = line.startsWith(QLatin1String("@@"));
+		previousSnapshot = m_snapshot;
 
-	if (definition->isException)
-	{
-		line = line.mid(2);
+		m_snapshot = snapshot;
+		m_loadingFuture = QFuture<QSharedPointer<Snapshot> >();
 	}
 
-	definition->needsDomainCheck = line.startsWith(QLatin1String("||"));
+	m_isLoading.storeRelease(0);
 
-	if (definition->needsDomainCheck)
-	{
-		line = line.mid(2);
-	}
+	emit rulesModified();
+}
+
+void AdblockContentFiltersProfile::removeCaches(const QString &cachePath, const QString &excludedPath)
+{
+	const QFileInfo information(cachePath);
+	const QDir directory(information.path());
+	const QStringList fileNames(directory.entryList({information.completeBaseName() + QLatin1String(".*.cache"), information.fileName()}, QDir::Files));
 
-	if (line.startsWith(QLatin1Char('|')))
+	for (int i = 0; i < fileNames.count(); ++i)
 	{
-		definition->ruleMatch = StartMatch;
+		const QString path(directory.filePath(fileNames.at(i)));
 
-		line = line.mid(1);
+		if (path != excludedPath)
+		{
+			QFile::remove(path);
+		}
 	}
+}
 
-	if (line.endsWith(QLatin1Char('|')))
-	{
-		definition->ruleMatch = ((definition->ruleMatch == StartMatch) ? ExactMatch : EndMatch);
+void AdblockContentFiltersProfile::parseRuleLine(const QString &rule, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled, Snapshot *snapshot, const Snapshot *previousSnapshot, const QHash<QStringView, int> &previousRules)
+{
+	const QHash<QStringView, int>::const_iterator iterator(previousRules.constFind(QStringView(rule)));
+	const int index((iterator == previousRules.constEnd()) ? snapshot->matcher.addRuleLine(rule, cosmeticFiltersMode, areWildcardsEnabled) : snapshot->matcher.addRule(previousSnapshot->matcher.getRule(iterator.value())));
 
-		line = line.left(line.length() - 1);
+	if (index < 0 || snapshot->nodes.isEmpty())
+	{
+		return;
 	}
 
-	for (int i = 0; i < options.count(); ++i)
+	const QString line(snapshot->matcher.getRule(index).pattern);
+
+	int node(0);
+
+	for (int i = 0; i < line.length(); ++i)
 	{
-		const QString option(options.at(i));
-		const bool isOptionException(option.startsWith(QLatin1Char('~')));
-		const QString optionName(isOptionException ? option.mid(1) : option);
+		const QChar value(line.at(i));
+		int previousNode(-1);
+		int nextNode(snapshot->nodes.at(node).firstChild);
+
+		while (nextNode >= 0 && snapshot->nodes.at(nextNode).value != value)
+		{
+			previousNode = nextNode;
+			nextNode = snapshot->nodes.at(nextNode).nextSibling;
+		}
 
-		if (m_options.contains(optionName))
+		if (nextNode < 0)
 		{
-			const RuleOption ruleOption(m_options.value(optionName));
+			Node newNode;
+			newNode.value = value;
+
+			nextNode = snapshot->nodes.count();
 
-			if ((!definition->isException || isOptionException) && (ruleOption == ElementHideOption || ruleOption == GenericHideOption))
+			if (value == QLatin1Char('^'))
 			{
-				continue;
-			}
+				newNode.nextSibling = snapshot->nodes.at(node).firstChild;
 
-			if (!isOptionException)
+				snapshot->nodes[node].firstChild = nextNode;
+			}
+			else if (previousNode >= 0)
 			{
-				definition->ruleOptions |= ruleOption;
+				snapshot->nodes[previousNode].nextSibling = nextNode;
 			}
-			else if (ruleOption != WebSocketOption && ruleOption != PopupOption)
+			else
 			{
-				definition->ruleExceptions |= ruleOption;
+				snapshot->nodes[node].firstChild = nextNode;
 			}
+
+			snapshot->nodes.append(newNode);
 		}
-		else if (optionName.startsWith(QLatin1String("domain")))
-		{
-			const QStringList parsedDomains(option.mid(option.indexOf(QLatin1Char('=')) + 1).split(QLatin1Char('|'), Qt::SkipEmptyParts));
 
-			for (int j = 0; j < parsedDomains.count(); ++j)
-			{
-				const QString parsedDomain(parsedDomains.at(j));
+		node = nextNode;
+	}
 
-				if (parsedDomain.startsWith(QLatin1Char('~')))
-				{
-					definition->allowedDomains.append(parsedDomain.mid(1));
-				}
-				else
-				{
-					definition->blockedDomains.append(parsedDomain);
-				}
-			}
-		}
-		else
-		{
-			return;
-		}
+	NodeRule nodeRule;
+	nodeRule.rule = index;
+
+	const int nodeRuleIndex(snapshot->nodeRules.count());
+
+	snapshot->nodeRules.append(nodeRule);
+
+	if (snapshot->nodes.at(node).lastRule >= 0)
+	{
+		snapshot->nodeRules[snapshot->nodes.at(node).lastRule].nextRule = nodeRuleIndex;
+	}
+	else
+	{
+		snapshot->nodes[node].firstRule = nodeRuleIndex;
 	}
 
-	Node *node(m_root);
+	snapshot->nodes[node].lastRule = nodeRuleIndex;
+}
 
-	for (int i = 0; i < line.length(); ++i)
+QSharedPointer<AdblockContentFiltersProfile::Snapshot> AdblockContentFiltersProfile::createSnapshot(const QString &path, const QString &cachePath, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled, MatcherMode matcherMode, bool canSaveCache, const QSharedPointer<Snapshot> &previousSnapshot)
+{
+	const quint32 cacheSettings(getCacheSettings(cosmeticFiltersMode, areWildcardsEnabled));
+	QSharedPointer<Snapshot> snapshot(new Snapshot());
+	snapshot->matcherMode = matcherMode;
+	snapshot->settings = cacheSettings;
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
 	{
-		const QChar value(line.at(i));
-		bool hasChildren(false);
+		snapshot->matcher.compile();
 
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			Node *nextNode(node->children.at(j));
+		return snapshot;
+	}
 
-			if (nextNode->value == value)
-			{
-				node = nextNode;
+	snapshot->checksum = getChecksum(&file);
 
-				hasChildren = true;
+	const QString snapshotCachePath(getCachePath(cachePath, snapshot->checksum, cacheSettings));
 
-				break;
-			}
-		}
+	if (matcherMode == IndexMatcherMode && snapshot->matcher.load(snapshotCachePath, snapshot->checksum, cacheSettings))
+	{
+		file.close();
 
-		if (!hasChildren)
-		{
-			Node *newNode(new Node());
-			newNode->value = value;
+		return snapshot;
+	}
 
-			if (value == QLatin1Char('^'))
-			{
-				node->children.insert(0, newNode);
-			}
-			else
-			{
-				node->children.append(newNode);
-			}
+	file.reset();
 
-			node = newNode;
-		}
+	const QHash<QStringView, int> previousRules((previousSnapshot && previousSnapshot->settings == cacheSettings) ? previousSnapshot->matcher.getRuleIndexes() : QHash<QStringView, int>());
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+	stream.readLine(); // skip header
+
+	if (matcherMode != IndexMatcherMode)
+	{
+		snapshot->nodes.append(Node());
 	}
 
-	node->rules.append(definition);
-}
+	while (!stream.atEnd())
+	{
+		parseRuleLine(stream.readLine(), cosmeticFiltersMode, areWildcardsEnabled, snapshot.data(), previousSnapshot.data(), previousRules);
+	}
 
-void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list)
-{
-	const QStringList domains(line.at(0).split(QLatin1Char(',')));
+	file.close();
 
-	for (int i = 0; i < domains.count(); ++i)
+	snapshot->matcher.compile();
+
+	if (canSaveCache)
 	{
-		list.insert(domains.at(i), line.at(1));
+		snapshot->hasCacheError = !snapshot->matcher.save(snapshotCachePath, snapshot->checksum, cacheSettings);
+
+		if (!snapshot->hasCacheError)
+		{
+			removeCaches(cachePath, snapshotCachePath);
+		}
 	}
+
+	return snapshot;
 }
 
-void AdblockContentFiltersProfile::deleteNode(Node *node) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlTree(const Snapshot *snapshot, const AdblockContentFiltersMatcher::Request &request)
 {
-	for (int i = 0; i < node->children.count(); ++i)
+	ContentFiltersManager::CheckResult result;
+
+	if (snapshot->nodes.isEmpty())
 	{
-		deleteNode(node->children.at(i));
+		return result;
 	}
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	for (int i = 0; i < request.requestUrl.length(); ++i)
 	{
-		delete node->rules.at(i);
+		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(snapshot, 0, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
 	}
 
-	delete node;
+	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Snapshot *snapshot, int node, const QString &subString, QString currentRule, const AdblockContentFiltersMatcher::Request &request)
 {
 	ContentFiltersManager::CheckResult result;
 	ContentFiltersManager::CheckResult currentResult;
@@ -346,7 +432,7 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 		const QChar treeChar(subString.at(i));
 		bool childrenExists(false);
 
-		currentResult = evaluateNodeRules(node, currentRule, request);
+		currentResult = evaluateNodeRules(snapshot, node, currentRule, request);
 
 		if (currentResult.isBlocked)
 		{
@@ -357,17 +443,17 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 			return currentResult;
 		}
 
-		for (int j = 0; j < node->children.count(); ++j)
+		for (int nextNode = snapshot->nodes.at(node).firstChild; nextNode >= 0; nextNode = snapshot->nodes.at(nextNode).nextSibling)
 		{
-			const Node *nextNode(node->children.at(j));
+			const QChar value(snapshot->nodes.at(nextNode).value);
 
-			if (nextNode->value == QLatin1Char('*'))
+			if (value == QLatin1Char('*'))
 			{
 				const QString wildcardSubString(subString.mid(i));
 
 				for (int k = 0; k < wildcardSubString.length(); ++k)
 				{
-					currentResult = checkUrlSubstring(nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
+					currentResult = checkUrlSubstring(snapshot, nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
 
 					if (currentResult.isBlocked)
 					{
@@ -380,9 +466,9 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 				}
 			}
 
-			if (nextNode->value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
+			if (value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
 			{
-				currentResult = checkUrlSubstring(nextNode, subString.mid(i), currentRule, request);
+				currentResult = checkUrlSubstring(snapshot, nextNode, subString.mid(i), currentRule, request);
 
 				if (currentResult.isBlocked)
 				{
@@ -394,7 +480,7 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 				}
 			}
 
-			if (nextNode->value == treeChar)
+			if (value == treeChar)
 			{
 				node = nextNode;
 
@@ -412,7 +498,7 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 		currentRule += treeChar;
 	}
 
-	currentResult = evaluateNodeRules(node, currentRule, request);
+	currentResult = evaluateNodeRules(snapshot, node, currentRule, request);
 
 	if (currentResult.isBlocked)
 	{
@@ -423,14 +509,14 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 		return currentResult;
 	}
 
-	for (int i = 0; i < node->children.count(); ++i)
+	for (int child = snapshot->nodes.at(node).firstChild; child >= 0; child = snapshot->nodes.at(child).nextSibling)
 	{
-		if (node->children.at(i)->value != QLatin1Char('^'))
+		if (snapshot->nodes.at(child).value != QLatin1Char('^'))
 		{
 			continue;
 		}
 
-		currentResult = evaluateNodeRules(node, currentRule, request);
+		currentResult = evaluateNodeRules(snapshot, node, currentRule, request);
 
 		if (currentResult.isBlocked)
 		{
@@ -445,137 +531,6 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const
-{
-	switch (rule->ruleMatch)
-	{
-		case StartMatch:
-			if (!request.requestUrl.startsWith(currentRule))
-			{
-				return {};
-			}
-
-			break;
-		case EndMatch:
-			if (!request.requestUrl.endsWith(currentRule))
-			{
-				return {};
-			}
-
-			break;
-		case ExactMatch:
-			if (request.requestUrl != currentRule)
-			{
-				return {};
-			}
-
-			break;
-		default:
-			if (!request.requestUrl.contains(currentRule))
-			{
-				return {};
-			}
-
-			break;
-	}
-
-	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
-
-	if (rule->needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
-	{
-		return {};
-	}
-
-	const bool hasBlockedDomains(!rule->blockedDomains.isEmpty());
-	const bool hasAllowedDomains(!rule->allowedDomains.isEmpty());
-	bool isBlocked(true);
-
-	if (hasBlockedDomains)
-	{
-		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
-
-		if (!isBlocked)
-		{
-			return {};
-		}
-	}
-
-	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
-
-	if (rule->ruleOptions.testFlag(ThirdPartyOption) || rule->ruleExceptions.testFlag(ThirdPartyOption))
-	{
-		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
-		{
-			isBlocked = rule->ruleExceptions.testFlag(ThirdPartyOption);
-		}
-		else if (!hasBlockedDomains && !hasAllowedDomains)
-		{
-			isBlocked = rule->ruleOptions.testFlag(ThirdPartyOption);
-		}
-	}
-
-	if (rule->ruleOptions != NoOption || rule->ruleExceptions != NoOption)
-	{
-		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
-
-		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
-		{
-			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
-
-			if (!rule->ruleOptions.testFlag(iterator.value()) && !(supportsException && rule->ruleExceptions.testFlag(iterator.value())))
-			{
-				continue;
-			}
-
-			if (request.resourceType == iterator.key())
-			{
-				isBlocked = (isBlocked ? rule->ruleOptions.testFlag(iterator.value()) : isBlocked);
-			}
-			else if (supportsException)
-			{
-				isBlocked = (isBlocked ? rule->ruleExceptions.testFlag(iterator.value()) : isBlocked);
-			}
-			else
-			{
-				isBlocked = false;
-			}
-		}
-	}
-	else if (request.resourceType == NetworkManager::PopupType)
-	{
-		isBlocked = false;
-	}
-
-	if (!isBlocked)
-	{
-		return {};
-	}
-
-	ContentFiltersManager::CheckResult result;
-	result.rule = rule->rule;
-
-	if (rule->isException)
-	{
-		result.isBlocked = false;
-		result.isException = true;
-
-		if (rule->ruleOptions.testFlag(ElementHideOption))
-		{
-			result.comesticFiltersMode = ContentFiltersManager::NoFilters;
-		}
-		else if (rule->ruleOptions.testFlag(GenericHideOption))
-		{
-			result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
-		}
-
-		return result;
-	}
-
-	result.isBlocked = true;
-
-	return result;
-}
-
 void AdblockContentFiltersProfile::raiseError(const QString &message, ProfileError error)
 {
 	m_error = error;
@@ -593,17 +548,42 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 	}
 
 	QIODevice *device(m_dataFetchJob->getData());
+	QSharedPointer<Snapshot> snapshot;
+
+	{
+		QReadLocker locker(&m_snapshotLock);
+
+		snapshot = m_snapshot;
+	}
+
+	const bool wasLoaded(snapshot || m_isLoading.loadAcquire() == 1);
+	const bool isModified(!isSuccess || m_dataFetchJob->getStatusCode() != 304);
+	const QByteArray entityTag(isSuccess ? m_dataFetchJob->getHeader(QByteArrayLiteral("ETag")) : QByteArray());
+	const QByteArray lastModified(isSuccess ? m_dataFetchJob->getHeader(QByteArrayLiteral("Last-Modified")) : QByteArray());
 
 	m_dataFetchJob->deleteLater();
 	m_dataFetchJob = nullptr;
 
 	if (!isSuccess)
 	{
+		m_isLoading.storeRelease(0);
+
 		raiseError(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(device ? device->errorString() : tr("Download failure")), DownloadError);
 
 		return;
 	}
 
+	if (!isModified)
+	{
+		m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
+
+		emit profileModified();
+
+		return;
+	}
+
+	m_isLoading.storeRelease(0);
+
 	QBuffer buffer;
 	buffer.setData(device->readAll());
 	buffer.open(QIODevice::ReadOnly | QIODevice::Text);
@@ -630,21 +610,26 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 		return;
 	}
 
+	bool hasSameRules(snapshot && snapshot->settings == getCacheSettings(m_profileSummary.cosmeticFiltersMode, m_profileSummary.areWildcardsEnabled) && snapshot->checksum == getChecksum(&buffer));
+
 	file.write(buffer.data());
 
+	m_profileSummary.entityTag = entityTag;
+	m_profileSummary.lastModified = lastModified;
 	m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
 
 	if (!file.commit())
 	{
 		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+		hasSameRules = false;
 	}
 
-	clear();
 	loadHeader();
 
-	if (m_wasLoaded)
+	if (!hasSameRules)
 	{
-		loadRules();
+		loadRules(wasLoaded);
 	}
 
 	emit profileModified();
@@ -663,7 +648,17 @@ void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile
 		return;
 	}
 
-	m_profileSummary = profileSummary;
+	const bool hasSameUpdateUrl(profileSummary.updateUrl == m_profileSummary.updateUrl);
+	const QByteArray entityTag(hasSameUpdateUrl ? m_profileSummary.entityTag : QByteArray());
+	const QByteArray lastModified(hasSameUpdateUrl ? m_profileSummary.lastModified : QByteArray());
+
+	{
+		QWriteLocker locker(&m_snapshotLock);
+
+		m_profileSummary = profileSummary;
+		m_profileSummary.entityTag = entityTag;
+		m_profileSummary.lastModified = lastModified;
+	}
 
 	if (needsReload)
 	{
@@ -688,6 +683,51 @@ QString AdblockContentFiltersProfile::getPath() const
 	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
 }
 
+QString AdblockContentFiltersProfile::getCachePath() const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.cache")).arg(m_profileSummary.name);
+}
+
+QString AdblockContentFiltersProfile::getCachePath(const QString &cachePath, const QByteArray &checksum, quint32 settings)
+{
+	const QFileInfo information(cachePath);
+
+	return QDir(information.path()).filePath(information.completeBaseName() + QLatin1Char('.') + QString::number(settings, 16) + QLatin1Char('.') + QString::fromLatin1(checksum.toHex().left(16)) + QLatin1String(".cache"));
+}
+
+QSharedPointer<const AdblockContentFiltersMatcher> AdblockContentFiltersProfile::getMatcher()
+{
+	const QSharedPointer<Snapshot> snapshot(getSnapshot());
+
+	if (!snapshot)
+	{
+		return {};
+	}
+
+	return QSharedPointer<const AdblockContentFiltersMatcher>(&snapshot->matcher, [=](const AdblockContentFiltersMatcher*)
+	{
+		Q_UNUSED(snapshot)
+	});
+}
+
+QSharedPointer<AdblockContentFiltersProfile::Snapshot> AdblockContentFiltersProfile::getSnapshot()
+{
+	QSharedPointer<Snapshot> snapshot;
+
+	{
+		QReadLocker locker(&m_snapshotLock);
+
+		snapshot = m_snapshot;
+	}
+
+	if (!snapshot)
+	{
+		load();
+	}
+
+	return snapshot;
+}
+
 QDateTime AdblockContentFiltersProfile::getLastUpdate() const
 {
 	return m_profileSummary.lastUpdate;
@@ -705,22 +745,24 @@ ContentFiltersProfile::ProfileSummary AdblockContentFiltersProfile::getProfileSu
 
 ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCosmeticFilters(const QStringList &domains, bool isDomainOnly)
 {
-	if (!m_wasLoaded)
+	const QSharedPointer<Snapshot> snapshot(getSnapshot());
+
+	if (!snapshot)
 	{
-		loadRules();
+		return {};
 	}
 
 	ContentFiltersManager::CosmeticFiltersResult result;
 
 	if (!isDomainOnly)
 	{
-		result.rules = m_cosmeticFiltersRules;
+		result.rules = snapshot->matcher.getCosmeticFilters();
 	}
 
 	for (int i = 0; i < domains.count(); ++i)
 	{
-		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
-		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+		result.rules.append(snapshot->matcher.getCosmeticDomainFilters(domains.at(i)));
+		result.exceptions.append(snapshot->matcher.getCosmeticDomainExceptions(domains.at(i)));
 	}
 
 	return result;
@@ -728,46 +770,51 @@ ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCo
 
 ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType)
 {
-	ContentFiltersManager::CheckResult result;
+	const QSharedPointer<Snapshot> snapshot(getSnapshot());
 
-	if (!m_wasLoaded && !loadRules())
+	if (!snapshot)
 	{
-		return result;
+		return {};
 	}
 
-	const Request request(baseUrl, requestUrl, resourceType);
+	const AdblockContentFiltersMatcher::Request request(baseUrl, requestUrl, resourceType);
+	ContentFiltersManager::CheckResult result;
 
-	for (int i = 0; i < request.requestUrl.length(); ++i)
+	if (snapshot->matcherMode == TrieMatcherMode)
+	{
+		result = checkUrlTree(snapshot.data(), request);
+	}
+	else
 	{
-		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(m_root, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
+		result = snapshot->matcher.checkUrl(request);
 
-		if (currentResult.isBlocked)
-		{
-			result = currentResult;
-		}
-		else if (currentResult.isException)
+		if (snapshot->matcherMode == CompareMatchersMode)
 		{
-			return currentResult;
+			const ContentFiltersManager::CheckResult referenceResult(checkUrlTree(snapshot.data(), request));
+
+			if (result.isBlocked != referenceResult.isBlocked || result.isException != referenceResult.isException || result.comesticFiltersMode != referenceResult.comesticFiltersMode)
+			{
+				const QString message(QCoreApplication::translate("main", "Content blocking matchers mismatch for profile %1:\nindex: %2\ntrie: %3").arg(getName(), result.rule, referenceResult.rule));
+				const QString source(request.requestUrl);
+
+				QMetaObject::invokeMethod(this, [=]()
+				{
+					Console::addMessage(message, Console::ContentFiltersCategory, Console::WarningLevel, source);
+				}, Qt::QueuedConnection);
+			}
 		}
 	}
 
 	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Snapshot *snapshot, int node, const QString &currentRule, const AdblockContentFiltersMatcher::Request &request)
 {
 	ContentFiltersManager::CheckResult result;
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	for (int nodeRule = snapshot->nodes.at(node).firstRule; nodeRule >= 0; nodeRule = snapshot->nodeRules.at(nodeRule).nextRule)
 	{
-		Node::Rule *rule(node->rules.at(i));
-
-		if (!rule)
-		{
-			continue;
-		}
-
-		ContentFiltersManager::CheckResult currentResult(checkRuleMatch(rule, currentRule, request));
+		const ContentFiltersManager::CheckResult currentResult(snapshot->matcher.checkRuleMatch(snapshot->nodeRules.at(nodeRule).rule, currentRule, request));
 
 		if (currentResult.isBlocked)
 		{
@@ -919,6 +966,53 @@ ContentFiltersProfile::ProfileFlags AdblockContentFiltersProfile::getFlags() con
 	return m_flags;
 }
 
+QByteArray AdblockContentFiltersProfile::getChecksum(QIODevice *device)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+
+	device->readLine();
+
+	while (!device->atEnd())
+	{
+		QByteArray line(device->readLine());
+
+		while (line.endsWith('\n') || line.endsWith('\r'))
+		{
+			line.chop(1);
+		}
+
+		if (!line.isEmpty() && !line.startsWith('!'))
+		{
+			hash.addData(line);
+			hash.addData("\n", 1);
+		}
+	}
+
+	return hash.result();
+}
+
+quint32 AdblockContentFiltersProfile::getCacheSettings(ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled)
+{
+	return (static_cast<quint32>(cosmeticFiltersMode) | (areWildcardsEnabled ? 0x100 : 0));
+}
+
+AdblockContentFiltersProfile::MatcherMode AdblockContentFiltersProfile::getMatcherMode()
+{
+	const QString matcherMode(SettingsManager::getOption(SettingsManager::ContentBlocking_MatcherModeOption).toString());
+
+	if (matcherMode == QLatin1String("trie"))
+	{
+		return TrieMatcherMode;
+	}
+
+	if (matcherMode == QLatin1String("compare"))
+	{
+		return CompareMatchersMode;
+	}
+
+	return IndexMatcherMode;
+}
+
 int AdblockContentFiltersProfile::getUpdateInterval() const
 {
 	return m_profileSummary.updateInterval;
@@ -1026,46 +1120,6 @@ bool AdblockContentFiltersProfile::create(const QUrl &url, bool canOverwriteExis
 	return result;
 }
 
-bool AdblockContentFiltersProfile::loadRules()
-{
-	const QString path(getPath());
-
-	m_error = NoError;
-
-	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
-	{
-		update();
-
-		return false;
-	}
-
-	m_wasLoaded = true;
-
-	if (m_domainExpression.pattern().isEmpty())
-	{
-		m_domainExpression = QRegularExpression(QLatin1String("[:\?&/=]"));
-		m_domainExpression.optimize();
-	}
-
-	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
-
-	QTextStream stream(&file);
-	stream.setCodec("UTF-8");
-	stream.readLine(); // skip header
-
-	m_root = new Node();
-
-	while (!stream.atEnd())
-	{
-		parseRuleLine(stream.readLine());
-	}
-
-	file.close();
-
-	return true;
-}
-
 bool AdblockContentFiltersProfile::update(const QUrl &url)
 {
 	if (m_dataFetchJob || thread() != QThread::currentThread())
@@ -1091,6 +1145,19 @@ bool AdblockContentFiltersProfile::update(const QUrl &url)
 
 	m_dataFetchJob = new DataFetchJob(updateUrl, this);
 
+	if (updateUrl == m_profileSummary.updateUrl && QFile::exists(getPath()))
+	{
+		if (!m_profileSummary.entityTag.isEmpty())
+		{
+			m_dataFetchJob->setHeader(QByteArrayLiteral("If-None-Match"), m_profileSummary.entityTag);
+		}
+
+		if (!m_profileSummary.lastModified.isEmpty())
+		{
+			m_dataFetchJob->setHeader(QByteArrayLiteral("If-Modified-Since"), m_profileSummary.lastModified);
+		}
+	}
+
 	connect(m_dataFetchJob, &Job::jobFinished, this, &AdblockContentFiltersProfile::handleJobFinished);
 	connect(m_dataFetchJob, &Job::progressChanged, this, &AdblockContentFiltersProfile::updateProgressChanged);
 
@@ -1112,6 +1179,8 @@ bool AdblockContentFiltersProfile::remove()
 		m_dataFetchJob = nullptr;
 	}
 
+	removeCaches(getCachePath());
+
 	if (QFile::exists(path))
 	{
 		return QFile::remove(path);
@@ -1120,19 +1189,6 @@ bool AdblockContentFiltersProfile::remove()
 	return true;
 }
 
-bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const QStringList &ruleList) const
-{
-	for (int i = 0; i < ruleList.count(); ++i)
-	{
-		if (url.contains(ruleList.at(i)))
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
 bool AdblockContentFiltersProfile::areWildcardsEnabled() const
 {
 	return m_profileSummary.areWildcardsEnabled;
@@ -22,9 +22,10 @@
 #ifndef OTTER_ADBLOCKCONTENTFILTERSPROFILE_H
 #define OTTER_ADBLOCKCONTENTFILTERSPROFILE_H
 
-#include "ContentFiltersManager.h"
+#include "AdblockContentFiltersMatcher.h"
 
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFuture>
+#include <QtCore/QReadWriteLock>
 
 namespace Otter
 {
@@ -60,6 +61,7 @@ public:
 	explicit AdblockContentFiltersProfile(const ProfileSummary &profileSummary, const QStringList &languages, ProfileFlags flags, QObject *parent = nullptr);
 
 	void clear() override;
+	void load() override;
 	void setProfileSummary(const ProfileSummary &profileSummary) override;
 	QString getName() const override;
 	QString getTitle() const override;
@@ -80,6 +82,7 @@ public:
 	int getUpdateProgress() const override;
 	static bool create(const ProfileSummary &profileSummary, QIODevice *rulesDevice = nullptr, bool canOverwriteExisting = false);
 	static bool create(const QUrl &url, bool canOverwriteExisting = false);
+	QSharedPointer<const AdblockContentFiltersMatcher> getMatcher();
 	bool update(const QUrl &url = {}) override;
 	bool remove() override;
 	bool areWildcardsEnabled() const override;
@@ -87,97 +90,71 @@ public:
 	bool isUpdating() const override;
 
 protected:
-	enum RuleOption : quint16
+	enum MatcherMode
 	{
-		NoOption = 0,
-		ThirdPartyOption = 1,
-		StyleSheetOption = 2,
-		ScriptOption = 4,
-		ImageOption = 8,
-		ObjectOption = 16,
-		ObjectSubRequestOption = 32,
-		SubDocumentOption = 64,
-		XmlHttpRequestOption = 128,
-		WebSocketOption = 256,
-		PopupOption = 512,
-		ElementHideOption = 1024,
-		GenericHideOption = 2048
-	};
-
-	Q_DECLARE_FLAGS(RuleOptions, RuleOption)
-
-	enum RuleMatch
-	{
-		ContainsMatch = 0,
-		StartMatch,
-		EndMatch,
-		ExactMatch
+		IndexMatcherMode = 0,
+		TrieMatcherMode,
+		CompareMatchersMode
 	};
 
 	struct Node final
 	{
-		struct Rule final
-		{
-			QString rule;
-			QStringList blockedDomains;
-			QStringList allowedDomains;
-			RuleOptions ruleOptions = NoOption;
-			RuleOptions ruleExceptions = NoOption;
-			RuleMatch ruleMatch = ContainsMatch;
-			bool isException = false;
-			bool needsDomainCheck = false;
-		};
-
 		QChar value = 0;
-		QVarLengthArray<Node*, 1> children;
-		QVarLengthArray<Rule*, 1> rules;
+		int firstChild = -1;
+		int nextSibling = -1;
+		int firstRule = -1;
+		int lastRule = -1;
 	};
 
-	struct Request final
+	struct NodeRule final
 	{
-		QString baseHost;
-		QString requestHost;
-		QString requestUrl;
-		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+		int rule = -1;
+		int nextRule = -1;
+	};
 
-		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), resourceType(resourceTypeValue)
-		{
-			if (requestUrl.startsWith(QLatin1String("//")))
-			{
-				requestUrl = requestUrl.mid(2);
-			}
-		}
+	struct Snapshot final
+	{
+		AdblockContentFiltersMatcher matcher;
+		QByteArray checksum;
+		QVector<Node> nodes;
+		QVector<NodeRule> nodeRules;
+		MatcherMode matcherMode = IndexMatcherMode;
+		quint32 settings = 0;
+		bool hasCacheError = false;
 	};
 
 	void loadHeader();
-	void parseRuleLine(const QString &rule);
-	void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
-	void deleteNode(Node *node) const;
-	ContentFiltersManager::CheckResult checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const;
-	bool loadRules();
-	bool resolveDomainExceptions(const QString &url, const QStringList &ruleList) const;
+	void loadRules(bool canReplace);
+	void startLoading(bool canReplace);
+	void replaceSnapshot(const QSharedPointer<Snapshot> &snapshot, int generation);
+	static void removeCaches(const QString &cachePath, const QString &excludedPath = {});
+	static void parseRuleLine(const QString &rule, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled, Snapshot *snapshot, const Snapshot *previousSnapshot, const QHash<QStringView, int> &previousRules);
+	static QSharedPointer<Snapshot> createSnapshot(const QString &path, const QString &cachePath, ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled, MatcherMode matcherMode, bool canSaveCache, const QSharedPointer<Snapshot> &previousSnapshot);
+	QSharedPointer<Snapshot> getSnapshot();
+	static ContentFiltersManager::CheckResult checkUrlTree(const Snapshot *snapshot, const AdblockContentFiltersMatcher::Request &request);
+	static ContentFiltersManager::CheckResult checkUrlSubstring(const Snapshot *snapshot, int node, const QString &subString, QString currentRule, const AdblockContentFiltersMatcher::Request &request);
+	static ContentFiltersManager::CheckResult evaluateNodeRules(const Snapshot *snapshot, int node, const QString &currentRule, const AdblockContentFiltersMatcher::Request &request);
+	QString getCachePath() const;
+	static QString getCachePath(const QString &cachePath, const QByteArray &checksum, quint32 settings);
+	static QByteArray getChecksum(QIODevice *device);
+	static quint32 getCacheSettings(ContentFiltersManager::CosmeticFiltersMode cosmeticFiltersMode, bool areWildcardsEnabled);
+	static MatcherMode getMatcherMode();
 
 protected slots:
 	void raiseError(const QString &message, ProfileError error);
 	void handleJobFinished(bool isSuccess);
 
 private:
-	Node *m_root;
 	DataFetchJob *m_dataFetchJob;
 	ProfileSummary m_profileSummary;
-	QRegularExpression m_domainExpression;
-	QStringList m_cosmeticFiltersRules;
 	QVector<QLocale::Language> m_languages;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainRules;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainExceptions;
+	QSharedPointer<Snapshot> m_snapshot;
+	QFuture<QSharedPointer<Snapshot> > m_loadingFuture;
+	QReadWriteLock m_snapshotLock;
+	QAtomicInt m_isLoading;
 	ProfileError m_error;
 	ProfileFlags m_flags;
-	bool m_wasLoaded;
-
-	static QHash<QString, RuleOption> m_options;
-	static QHash<NetworkManager::ResourceType, RuleOption> m_resourceTypes;
+	int m_generation;
 };
 
 }
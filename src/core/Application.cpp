@@ -22,6 +22,7 @@
 #include "AddonsManager.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "ContentFiltersManager.h"
 #include "FeedsManager.h"
 #include "GesturesManager.h"
 #include "HandlersManager.h"
@@ -36,6 +37,7 @@
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
 #include "SpellCheckManager.h"
+#include "SuspensionManager.h"
 #include "TasksManager.h"
 #include "ToolBarsManager.h"
 #include "ThemesManager.h"
@@ -409,6 +411,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 		return;
 	}
 
+	SessionsManager::preloadSession(m_commandLineParser.value(QLatin1String("session")).isEmpty() ? QLatin1String("default") : m_commandLineParser.value(QLatin1String("session")));
+
 	TasksManager::createInstance();
 
 	ThemesManager::createInstance();
@@ -439,6 +443,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	SpellCheckManager::createInstance();
 
+	SuspensionManager::createInstance();
+
 	ToolBarsManager::createInstance();
 
 	TransfersManager::createInstance();
@@ -1418,12 +1424,17 @@ QString Application::createReport(ReportOptions options)
 		pathsReport.entries.append({QLatin1String("Session"), SessionsManager::getSessionPath(SessionsManager::getCurrentSession())});
 		pathsReport.entries.append({QLatin1String("Bookmarks"), SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel"))});
 		pathsReport.entries.append({QLatin1String("Notes"), SessionsManager::getWritableDataPath(QLatin1String("notes.xbel"))});
-		pathsReport.entries.append({QLatin1String("History"), SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json"))});
+		pathsReport.entries.append({QLatin1String("History"), SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat"))});
 		pathsReport.entries.append({QLatin1String("Cache"), SessionsManager::getCachePath()});
 
 		report.sections.append(pathsReport);
 	}
 
+	if (ContentFiltersManager::getInstance())
+	{
+		report.sections.append(ContentFiltersManager::createReport());
+	}
+
 	if (options.testFlag(SettingsReport))
 	{
 		report.sections.append(SettingsManager::createReport());
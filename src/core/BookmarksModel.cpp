@@ -26,12 +26,17 @@
 #include "ThemesManager.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeData>
 #include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+
 namespace Otter
 {
 
@@ -375,7 +380,8 @@ BookmarksModel::BookmarksModel(const QString &path, FormatMode mode, QObject *pa
 	m_rootItem(new Bookmark()),
 	m_trashItem(new Bookmark()),
 	m_importTargetItem(nullptr),
-	m_mode(mode)
+	m_mode(mode),
+	m_isLoading(false)
 {
 	m_rootItem->setData(RootBookmark, TypeRole);
 	m_rootItem->setDragEnabled(false);
@@ -392,49 +398,20 @@ BookmarksModel::BookmarksModel(const QString &path, FormatMode mode, QObject *pa
 		return;
 	}
 
-	QFile file(path);
-
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-	{
-		Console::addMessage(((mode == NotesMode) ? tr("Failed to open notes file: %1") : tr("Failed to open bookmarks file: %1")).arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+	m_isLoading = true;
 
-		return;
-	}
-
-	QXmlStreamReader reader(&file);
+	QFutureWatcher<LoadingResult> *watcher(new QFutureWatcher<LoadingResult>(this));
 
-	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	connect(watcher, &QFutureWatcher<LoadingResult>::finished, this, [=]()
 	{
-		while (reader.readNextStartElement())
-		{
-			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
-			{
-				readBookmark(&reader, m_rootItem);
-			}
-			else
-			{
-				reader.skipCurrentElement();
-			}
-
-			if (reader.hasError())
-			{
-				m_rootItem->removeRows(0, m_rootItem->rowCount());
+		const LoadingResult result(watcher->result());
 
-				Console::addMessage(((m_mode == NotesMode) ? tr("Failed to load notes file: %1") : tr("Failed to load bookmarks file: %1")).arg(reader.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+		watcher->deleteLater();
 
-				QMessageBox::warning(nullptr, tr("Error"), ((m_mode == NotesMode) ? tr("Failed to load notes file.") : tr("Failed to load bookmarks file.")), QMessageBox::Close);
-
-				return;
-			}
-		}
-	}
+		adoptBookmarks(result, path);
+	});
 
-	connect(this, &BookmarksModel::itemChanged, this, &BookmarksModel::modelModified);
-	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::modelModified);
-	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::notifyBookmarkModified);
-	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::modelModified);
-	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::notifyBookmarkModified);
-	connect(this, &BookmarksModel::rowsMoved, this, &BookmarksModel::modelModified);
+	watcher->setFuture(QtConcurrent::run(&BookmarksModel::loadBookmarks, path));
 }
 
 void BookmarksModel::beginImport(Bookmark *target, int estimatedUrlsAmount, int estimatedKeywordsAmount)
@@ -452,12 +429,14 @@ void BookmarksModel::beginImport(Bookmark *target, int estimatedUrlsAmount, int
 	if (estimatedKeywordsAmount > 0)
 	{
 		m_keywords.reserve(m_keywords.count() + estimatedKeywordsAmount);
+		m_sortedKeywords.reserve(m_sortedKeywords.count() + estimatedKeywordsAmount);
 	}
 }
 
 void BookmarksModel::endImport()
 {
 	m_urls.squeeze();
+	m_urlsIndex.optimize();
 	m_keywords.squeeze();
 
 	blockSignals(false);
@@ -561,9 +540,9 @@ void BookmarksModel::removeBookmark(Bookmark *bookmark)
 		m_identifiers.remove(identifier);
 	}
 
-	if (!bookmark->data(KeywordRole).toString().isEmpty() && m_keywords.contains(bookmark->data(KeywordRole).toString()))
+	if (!bookmark->data(KeywordRole).toString().isEmpty())
 	{
-		m_keywords.remove(bookmark->data(KeywordRole).toString());
+		handleKeywordChanged(bookmark, {}, bookmark->data(KeywordRole).toString());
 	}
 
 	emit bookmarkRemoved(bookmark, bookmark->getParent());
@@ -573,182 +552,223 @@ void BookmarksModel::removeBookmark(Bookmark *bookmark)
 	emit modelModified();
 }
 
-void BookmarksModel::readBookmark(QXmlStreamReader *reader, Bookmark *parent)
+void BookmarksModel::adoptBookmarks(const LoadingResult &result, const QString &path)
 {
-	Bookmark *bookmark(nullptr);
+	m_isLoading = false;
 
-	if (reader->name() == QLatin1String("folder"))
+	if (!result.isOpened)
 	{
-		bookmark = addBookmark(FolderBookmark, {{IdentifierRole, reader->attributes().value(QLatin1String("id")).toULongLong()}, {TimeAddedRole, readDateTime(reader, QLatin1String("added"))}, {TimeModifiedRole, readDateTime(reader, QLatin1String("modified"))}}, parent);
+		Console::addMessage(((m_mode == NotesMode) ? tr("Failed to open notes file: %1") : tr("Failed to open bookmarks file: %1")).arg(result.errorString), Console::OtherCategory, Console::ErrorLevel, path);
+
+		emit loadingFinished();
 
-		while (reader->readNext())
+		return;
+	}
+
+	if (!result.errorString.isEmpty())
+	{
+		Console::addMessage(((m_mode == NotesMode) ? tr("Failed to load notes file: %1") : tr("Failed to load bookmarks file: %1")).arg(result.errorString), Console::OtherCategory, Console::ErrorLevel, path);
+
+		emit loadingFinished();
+
+		QMessageBox::warning(nullptr, tr("Error"), ((m_mode == NotesMode) ? tr("Failed to load notes file.") : tr("Failed to load bookmarks file.")), QMessageBox::Close);
+
+		return;
+	}
+
+	const bool wasModified(m_rootItem->hasChildren());
+	QVector<Bookmark*> bookmarks;
+	bookmarks.reserve(result.nodes.count());
+	int row(0);
+
+	beginResetModel();
+	blockSignals(true);
+
+	for (int i = 0; i < result.nodes.count(); ++i)
+	{
+		const BookmarkNode &node(result.nodes.at(i));
+		Bookmark *parent((node.parent < 0) ? m_rootItem : bookmarks.at(node.parent));
+		const int index((node.parent < 0) ? row++ : -1);
+		Bookmark *bookmark(nullptr);
+
+		switch (node.type)
 		{
-			if (reader->isStartElement())
-			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), TitleRole);
-				}
-				else if (reader->name() == QLatin1String("desc"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), DescriptionRole);
-				}
-				else if (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator"))
-				{
-					readBookmark(reader, bookmark);
-				}
-				else if (reader->name() == QLatin1String("info"))
-				{
-					while (reader->readNext())
-					{
-						if (reader->isStartElement())
-						{
-							if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
-							{
-								while (reader->readNext())
-								{
-									if (reader->isStartElement())
-									{
-										if (reader->name() == QLatin1String("keyword"))
-										{
-											const QString keyword(reader->readElementText().trimmed());
-
-											if (!keyword.isEmpty())
-											{
-												bookmark->setItemData(keyword, KeywordRole);
-
-												handleKeywordChanged(bookmark, keyword);
-											}
-										}
-										else
-										{
-											reader->skipCurrentElement();
-										}
-									}
-									else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
-									{
-										break;
-									}
-								}
-							}
-							else
-							{
-								reader->skipCurrentElement();
-							}
-						}
-						else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
-						{
-							break;
-						}
-					}
-				}
-				else
-				{
-					reader->skipCurrentElement();
-				}
-			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("folder"))
-			{
+			case FeedBookmark:
+			case UrlBookmark:
+				bookmark = addBookmark(node.type, {{IdentifierRole, node.identifier}, {UrlRole, node.url}, {TimeAddedRole, node.timeAdded}, {TimeModifiedRole, node.timeModified}, {TimeVisitedRole, node.timeVisited}}, parent, index);
+
 				break;
-			}
-			else if (reader->hasError())
-			{
-				return;
-			}
+			case FolderBookmark:
+				bookmark = addBookmark(FolderBookmark, {{IdentifierRole, node.identifier}, {TimeAddedRole, node.timeAdded}, {TimeModifiedRole, node.timeModified}}, parent, index);
+
+				break;
+			default:
+				bookmark = addBookmark(SeparatorBookmark, {}, parent, index);
+
+				break;
+		}
+
+		bookmarks.append(bookmark);
+
+		if (!node.title.isEmpty())
+		{
+			bookmark->setItemData(node.title, TitleRole);
+		}
+
+		if (!node.description.isEmpty())
+		{
+			bookmark->setItemData(node.description, DescriptionRole);
+		}
+
+		if (!node.keyword.isEmpty())
+		{
+			bookmark->setItemData(node.keyword, KeywordRole);
+
+			handleKeywordChanged(bookmark, node.keyword);
+		}
+
+		if (node.visits > 0)
+		{
+			bookmark->setItemData(node.visits, VisitsRole);
+		}
+
+		if (node.type == FeedBookmark)
+		{
+			setupFeed(bookmark);
 		}
 	}
+
+	m_urlsIndex.optimize();
+
+	blockSignals(false);
+	endResetModel();
+
+	connect(this, &BookmarksModel::itemChanged, this, &BookmarksModel::modelModified);
+	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::modelModified);
+	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::notifyBookmarkModified);
+	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::modelModified);
+	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::notifyBookmarkModified);
+	connect(this, &BookmarksModel::rowsMoved, this, &BookmarksModel::modelModified);
+
+	emit loadingFinished();
+
+	if (wasModified)
+	{
+		emit modelModified();
+	}
+}
+
+void BookmarksModel::readBookmark(QXmlStreamReader *reader, QVector<BookmarkNode> *nodes, int parent)
+{
+	BookmarkNode node;
+	node.parent = parent;
+
+	if (reader->name() == QLatin1String("separator"))
+	{
+		node.type = SeparatorBookmark;
+
+		nodes->append(node);
+
+		reader->readNext();
+
+		return;
+	}
+
+	if (reader->name() == QLatin1String("folder"))
+	{
+		node.type = FolderBookmark;
+	}
 	else if (reader->name() == QLatin1String("bookmark"))
 	{
-		const bool isFeed(reader->attributes().hasAttribute(QLatin1String("feed")));
+		node.type = (reader->attributes().hasAttribute(QLatin1String("feed")) ? FeedBookmark : UrlBookmark);
+		node.url = reader->attributes().value(QLatin1String("href")).toString();
+		node.timeVisited = readDateTime(reader, QLatin1String("visited"));
+	}
+	else
+	{
+		return;
+	}
 
-		bookmark = addBookmark((isFeed ? FeedBookmark : UrlBookmark), {{IdentifierRole, reader->attributes().value(QLatin1String("id")).toULongLong()}, {UrlRole, reader->attributes().value(QLatin1String("href")).toString()}, {TimeAddedRole, readDateTime(reader, QLatin1String("added"))}, {TimeModifiedRole, readDateTime(reader, QLatin1String("modified"))}, {TimeVisitedRole, readDateTime(reader, QLatin1String("visited"))}}, parent);
+	const QString elementName(reader->name().toString());
+	const int index(nodes->count());
 
-		while (reader->readNext())
+	node.identifier = reader->attributes().value(QLatin1String("id")).toULongLong();
+	node.timeAdded = readDateTime(reader, QLatin1String("added"));
+	node.timeModified = readDateTime(reader, QLatin1String("modified"));
+
+	nodes->append(node);
+
+	while (reader->readNext())
+	{
+		if (reader->isStartElement())
 		{
-			if (reader->isStartElement())
+			if (reader->name() == QLatin1String("title"))
 			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), TitleRole);
-				}
-				else if (reader->name() == QLatin1String("desc"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), DescriptionRole);
-				}
-				else if (reader->name() == QLatin1String("info"))
+				(*nodes)[index].title = reader->readElementText().trimmed();
+			}
+			else if (reader->name() == QLatin1String("desc"))
+			{
+				(*nodes)[index].description = reader->readElementText().trimmed();
+			}
+			else if (node.type == FolderBookmark && (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator")))
+			{
+				readBookmark(reader, nodes, index);
+			}
+			else if (reader->name() == QLatin1String("info"))
+			{
+				while (reader->readNext())
 				{
-					while (reader->readNext())
+					if (reader->isStartElement())
 					{
-						if (reader->isStartElement())
+						if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
 						{
-							if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
+							while (reader->readNext())
 							{
-								while (reader->readNext())
+								if (reader->isStartElement())
 								{
-									if (reader->isStartElement())
+									if (reader->name() == QLatin1String("keyword"))
+									{
+										(*nodes)[index].keyword = reader->readElementText().trimmed();
+									}
+									else if (node.type != FolderBookmark && reader->name() == QLatin1String("visits"))
 									{
-										if (reader->name() == QLatin1String("keyword"))
-										{
-											const QString keyword(reader->readElementText().trimmed());
-
-											if (!keyword.isEmpty())
-											{
-												bookmark->setItemData(keyword, KeywordRole);
-
-												handleKeywordChanged(bookmark, keyword);
-											}
-										}
-										else if (reader->name() == QLatin1String("visits"))
-										{
-											bookmark->setItemData(reader->readElementText().toInt(), VisitsRole);
-										}
-										else
-										{
-											reader->skipCurrentElement();
-										}
+										(*nodes)[index].visits = reader->readElementText().toInt();
 									}
-									else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
+									else
 									{
-										break;
+										reader->skipCurrentElement();
 									}
 								}
-							}
-							else
-							{
-								reader->skipCurrentElement();
+								else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
+								{
+									break;
+								}
 							}
 						}
-						else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
+						else
 						{
-							break;
+							reader->skipCurrentElement();
 						}
 					}
-				}
-				else
-				{
-					reader->skipCurrentElement();
+					else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
+					{
+						break;
+					}
 				}
 			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("bookmark"))
-			{
-				break;
-			}
-			else if (reader->hasError())
+			else
 			{
-				return;
+				reader->skipCurrentElement();
 			}
 		}
-
-		if (isFeed)
+		else if (reader->isEndElement() && reader->name() == elementName)
 		{
-			setupFeed(bookmark);
+			break;
+		}
+		else if (reader->hasError())
+		{
+			return;
 		}
-	}
-	else if (reader->name() == QLatin1String("separator"))
-	{
-		addBookmark(SeparatorBookmark, {}, parent);
-
-		reader->readNext();
 	}
 }
 
@@ -895,6 +915,7 @@ void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 					if (m_urls[url].isEmpty())
 					{
 						m_urls.remove(url);
+						m_urlsIndex.removeUrl(url);
 					}
 				}
 			}
@@ -931,6 +952,7 @@ void BookmarksModel::readdBookmarkUrl(Bookmark *bookmark)
 					if (!m_urls.contains(url))
 					{
 						m_urls[url] = {};
+						m_urlsIndex.addUrl(url, {});
 					}
 
 					m_urls[url].append(bookmark);
@@ -1037,13 +1059,35 @@ void BookmarksModel::handleFeedModified(Feed *feed)
 
 void BookmarksModel::handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword)
 {
+	const auto compare([&](const QString &first, const QString &second)
+	{
+		return (first.compare(second, Qt::CaseInsensitive) < 0);
+	});
+
 	if (!oldKeyword.isEmpty() && m_keywords.contains(oldKeyword))
 	{
 		m_keywords.remove(oldKeyword);
+
+		QStringList::iterator iterator(std::lower_bound(m_sortedKeywords.begin(), m_sortedKeywords.end(), oldKeyword, compare));
+
+		while (iterator != m_sortedKeywords.end() && iterator->compare(oldKeyword, Qt::CaseInsensitive) == 0 && *iterator != oldKeyword)
+		{
+			++iterator;
+		}
+
+		if (iterator != m_sortedKeywords.end() && *iterator == oldKeyword)
+		{
+			m_sortedKeywords.erase(iterator);
+		}
 	}
 
 	if (!newKeyword.isEmpty())
 	{
+		if (!m_keywords.contains(newKeyword))
+		{
+			m_sortedKeywords.insert(std::lower_bound(m_sortedKeywords.begin(), m_sortedKeywords.end(), newKeyword, compare), newKeyword);
+		}
+
 		m_keywords[newKeyword] = bookmark;
 	}
 }
@@ -1057,6 +1101,7 @@ void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, co
 		if (m_urls[oldUrl].isEmpty())
 		{
 			m_urls.remove(oldUrl);
+			m_urlsIndex.removeUrl(oldUrl);
 		}
 	}
 
@@ -1065,6 +1110,7 @@ void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, co
 		if (!m_urls.contains(newUrl))
 		{
 			m_urls[newUrl] = {};
+			m_urlsIndex.addUrl(newUrl, {});
 		}
 
 		m_urls[newUrl].append(bookmark);
@@ -1286,6 +1332,48 @@ QDateTime BookmarksModel::readDateTime(QXmlStreamReader *reader, const QString &
 	return dateTime;
 }
 
+BookmarksModel::LoadingResult BookmarksModel::loadBookmarks(const QString &path)
+{
+	LoadingResult result;
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		result.errorString = file.errorString();
+
+		return result;
+	}
+
+	result.isOpened = true;
+
+	QXmlStreamReader reader(&file);
+
+	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	{
+		while (reader.readNextStartElement())
+		{
+			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
+			{
+				readBookmark(&reader, &result.nodes, -1);
+			}
+			else
+			{
+				reader.skipCurrentElement();
+			}
+
+			if (reader.hasError())
+			{
+				result.nodes.clear();
+				result.errorString = reader.errorString();
+
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
 QStringList BookmarksModel::mimeTypes() const
 {
 	return {QLatin1String("text/uri-list")};
@@ -1298,26 +1386,24 @@ QStringList BookmarksModel::getKeywords() const
 
 QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix) const
 {
-	QVector<Bookmark*> matchedBookmarks;
+	QSet<Bookmark*> matchedBookmarks;
 	QVector<BookmarkMatch> allMatches;
 	QVector<BookmarkMatch> currentMatches;
 	QMultiMap<QDateTime, BookmarkMatch> matchesMap;
-	QHash<QString, Bookmark*>::const_iterator keywordsIterator;
-
-	for (keywordsIterator = m_keywords.constBegin(); keywordsIterator != m_keywords.constEnd(); ++keywordsIterator)
+	QStringList::const_iterator keywordsIterator(std::lower_bound(m_sortedKeywords.constBegin(), m_sortedKeywords.constEnd(), prefix, [&](const QString &keyword, const QString &value)
 	{
-		if (!keywordsIterator.key().startsWith(prefix, Qt::CaseInsensitive))
-		{
-			continue;
-		}
+		return (keyword.compare(value, Qt::CaseInsensitive) < 0);
+	}));
 
+	for (; keywordsIterator != m_sortedKeywords.constEnd() && keywordsIterator->startsWith(prefix, Qt::CaseInsensitive); ++keywordsIterator)
+	{
 		BookmarkMatch match;
-		match.bookmark = keywordsIterator.value();
-		match.match = keywordsIterator.key();
+		match.bookmark = m_keywords.value(*keywordsIterator);
+		match.match = *keywordsIterator;
 
 		matchesMap.insert(match.bookmark->getTimeVisited(), match);
 
-		matchedBookmarks.append(match.bookmark);
+		matchedBookmarks.insert(match.bookmark);
 	}
 
 	currentMatches = matchesMap.values().toVector();
@@ -1331,27 +1417,24 @@ QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QStri
 		allMatches.append(currentMatches.at(i));
 	}
 
-	QHash<QUrl, QVector<Bookmark*> >::const_iterator urlsIterator;
+	const QVector<QUrl> urls(m_urlsIndex.findPrefix(prefix));
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	for (int i = 0; i < urls.count(); ++i)
 	{
-		if (urlsIterator.value().isEmpty() || matchedBookmarks.contains(urlsIterator.value().value(0)))
+		Bookmark *bookmark(m_urls.value(urls.at(i)).value(0));
+
+		if (!bookmark || matchedBookmarks.contains(bookmark))
 		{
 			continue;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
-
-		if (!result.isEmpty())
-		{
-			BookmarkMatch match;
-			match.bookmark = urlsIterator.value().value(0);
-			match.match = result;
+		BookmarkMatch match;
+		match.bookmark = bookmark;
+		match.match = Utils::matchUrl(urls.at(i), prefix);
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+		matchesMap.insert(match.bookmark->getTimeVisited(), match);
 
-			matchedBookmarks.append(match.bookmark);
-		}
+		matchedBookmarks.insert(match.bookmark);
 	}
 
 	currentMatches = matchesMap.values().toVector();
@@ -1373,55 +1456,38 @@ QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, Boo
 		branch = m_rootItem;
 	}
 
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
-	QVector<Bookmark*> bookmarks;
+	const QVector<Bookmark*> bookmarks(getBookmarks(url));
+	QVector<Bookmark*> matchingBookmarks;
+	matchingBookmarks.reserve(bookmarks.count());
 
-	for (int i = 0; i < branch->rowCount(); ++i)
+	for (int i = 0; i < bookmarks.count(); ++i)
 	{
-		Bookmark *bookmark(branch->getChild(i));
+		Bookmark *bookmark(bookmarks.at(i));
 
-		if (!bookmark)
+		if (bookmark->getType() != UrlBookmark)
 		{
 			continue;
 		}
 
-		switch (bookmark->getType())
-		{
-			case FolderBookmark:
-				bookmarks.append(findUrls(url, bookmark));
+		QStandardItem *parent(bookmark->parent());
 
-				break;
-			case UrlBookmark:
-				if (normalizedUrl == Utils::normalizeUrl(bookmark->getUrl()))
-				{
-					bookmarks.append(bookmark);
-				}
+		while (parent && parent != branch && static_cast<Bookmark*>(parent)->getType() == FolderBookmark)
+		{
+			parent = parent->parent();
+		}
 
-				break;
-			default:
-				break;
+		if (parent == branch)
+		{
+			matchingBookmarks.append(bookmark);
 		}
 	}
 
-	return bookmarks;
+	return matchingBookmarks;
 }
 
 QVector<BookmarksModel::Bookmark*> BookmarksModel::getBookmarks(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
-	QVector<BookmarksModel::Bookmark*> bookmarks;
-
-	if (m_urls.contains(url))
-	{
-		bookmarks = m_urls[url];
-	}
-
-	if (url != normalizedUrl && m_urls.contains(normalizedUrl))
-	{
-		bookmarks.append(m_urls[normalizedUrl]);
-	}
-
-	return bookmarks;
+	return m_urls.value(Utils::normalizeUrl(url));
 }
 
 BookmarksModel::FormatMode BookmarksModel::getFormatMode() const
@@ -1534,7 +1600,7 @@ bool BookmarksModel::dropMimeData(const QMimeData *data, Qt::DropAction action,
 
 bool BookmarksModel::save(const QString &path) const
 {
-	if (SessionsManager::isReadOnly())
+	if (m_isLoading || SessionsManager::isReadOnly())
 	{
 		return false;
 	}
@@ -1652,4 +1718,9 @@ bool BookmarksModel::hasKeyword(const QString &keyword) const
 	return m_keywords.contains(keyword);
 }
 
+bool BookmarksModel::isLoading() const
+{
+	return m_isLoading;
+}
+
 }
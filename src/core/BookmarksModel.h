@@ -21,6 +21,9 @@
 #ifndef OTTER_BOOKMARKSMODEL_H
 #define OTTER_BOOKMARKSMODEL_H
 
+#include "HistoryIndex.h"
+
+#include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -140,6 +143,7 @@ public:
 	bool hasBookmark(const QUrl &url) const;
 	bool hasFeed(const QUrl &url) const;
 	bool hasKeyword(const QString &keyword) const;
+	bool isLoading() const;
 
 public slots:
 	void emptyTrash();
@@ -151,14 +155,38 @@ protected:
 		int row = -1;
 	};
 
-	void readBookmark(QXmlStreamReader *reader, Bookmark *parent);
+	struct BookmarkNode final
+	{
+		QString title;
+		QString description;
+		QString keyword;
+		QString url;
+		QDateTime timeAdded;
+		QDateTime timeModified;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		BookmarkType type = UnknownBookmark;
+		int parent = -1;
+		int visits = 0;
+	};
+
+	struct LoadingResult final
+	{
+		QVector<BookmarkNode> nodes;
+		QString errorString;
+		bool isOpened = false;
+	};
+
+	void adoptBookmarks(const LoadingResult &result, const QString &path);
 	void writeBookmark(QXmlStreamWriter *writer, Bookmark *bookmark) const;
 	void removeBookmarkUrl(Bookmark *bookmark);
 	void readdBookmarkUrl(Bookmark *bookmark);
 	void setupFeed(Bookmark *bookmark);
 	void handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword = {});
 	void handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl = {});
+	static void readBookmark(QXmlStreamReader *reader, QVector<BookmarkNode> *nodes, int parent);
 	static QDateTime readDateTime(QXmlStreamReader *reader, const QString &attribute);
+	static LoadingResult loadBookmarks(const QString &path);
 
 protected slots:
 	void handleFeedModified(Feed *feed);
@@ -172,8 +200,11 @@ private:
 	QHash<QUrl, QVector<Bookmark*> > m_feeds;
 	QHash<QUrl, QVector<Bookmark*> > m_urls;
 	QHash<QString, Bookmark*> m_keywords;
+	QStringList m_sortedKeywords;
 	QMap<quint64, Bookmark*> m_identifiers;
+	HistoryIndex m_urlsIndex;
 	FormatMode m_mode;
+	bool m_isLoading;
 
 signals:
 	void bookmarkAdded(Bookmark *bookmark);
@@ -183,6 +214,7 @@ signals:
 	void bookmarkRestored(Bookmark *bookmark);
 	void bookmarkRemoved(Bookmark *bookmark, Bookmark *previousParent);
 	void modelModified();
+	void loadingFinished();
 
 friend class Bookmark;
 };
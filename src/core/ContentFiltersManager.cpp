@@ -26,9 +26,12 @@
 #include "SettingsManager.h"
 #include "SessionsManager.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 
 namespace Otter
@@ -37,14 +40,48 @@ namespace Otter
 ContentFiltersManager* ContentFiltersManager::m_instance(nullptr);
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_contentBlockingProfiles;
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_fraudCheckingProfiles;
+QCache<QString, ContentFiltersManager::CosmeticFiltersStyleSheet> ContentFiltersManager::m_cosmeticFiltersStyleSheetsCache(500);
+QHash<QString, ContentFiltersManager::GenericCosmeticFilters> ContentFiltersManager::m_genericCosmeticFilters;
+QHash<QString, ContentFiltersManager::MergedMatcher> ContentFiltersManager::m_mergedMatchers;
+QHash<QString, int> ContentFiltersManager::m_pendingMergedMatchers;
+ContentFiltersManager::CheckResultsCacheShard ContentFiltersManager::m_checkResultsCacheShards[CheckResultsCacheShardsAmount];
+QMutex ContentFiltersManager::m_cosmeticFiltersCachesMutex;
+QReadWriteLock ContentFiltersManager::m_mergedMatchersLock;
+QAtomicInt ContentFiltersManager::m_checkResultsCacheGeneration(0);
+int ContentFiltersManager::m_mergedMatchersRevision(0);
+bool ContentFiltersManager::m_areProfilesMerged(false);
 
 ContentFiltersManager::ContentFiltersManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
 {
+	for (int i = 0; i < CheckResultsCacheShardsAmount; ++i)
+	{
+		m_checkResultsCacheShards[i].results.setMaxCost(CheckResultsCacheShardSize);
+	}
+
 	QTimer::singleShot(1000, this, [&]()
 	{
 		initialize();
 	});
+
+	m_areProfilesMerged = SettingsManager::getOption(SettingsManager::ContentBlocking_MergeProfilesOption).toBool();
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, [&](int identifier, const QVariant &value)
+	{
+		if (identifier == SettingsManager::ContentBlocking_MatcherModeOption)
+		{
+			for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+			{
+				m_contentBlockingProfiles.at(i)->clear();
+			}
+		}
+		else if (identifier == SettingsManager::ContentBlocking_MergeProfilesOption)
+		{
+			m_areProfilesMerged = value.toBool();
+
+			clearCaches();
+		}
+	});
 }
 
 void ContentFiltersManager::createInstance()
@@ -153,6 +190,8 @@ void ContentFiltersManager::initialize()
 
 		profileSummary.lastUpdate = QDateTime::fromString(profileObject.value(QLatin1String("lastUpdate")).toString(), Qt::ISODate);
 		profileSummary.lastUpdate.setTimeSpec(Qt::UTC);
+		profileSummary.entityTag = profileObject.value(QLatin1String("entityTag")).toString().toLatin1();
+		profileSummary.lastModified = profileObject.value(QLatin1String("lastModified")).toString().toLatin1();
 		profileSummary.category = categoryTitles.value(profileObject.value(QLatin1String("category")).toString());
 		profileSummary.updateInterval = profileObject.value(QLatin1String("updateInterval")).toInt();
 		profileSummary.areWildcardsEnabled = profileObject.value(QLatin1String("areWildcardsEnabled")).toBool();
@@ -176,9 +215,23 @@ void ContentFiltersManager::initialize()
 
 			emit m_instance->profileModified(profile->getName());
 		});
+		connect(profile, &ContentFiltersProfile::rulesModified, m_instance, &ContentFiltersManager::clearCaches);
 	}
 
 	m_contentBlockingProfiles.squeeze();
+
+	if (SettingsManager::getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption).toBool())
+	{
+		const QStringList enabledProfiles(SettingsManager::getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList());
+
+		for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+		{
+			if (enabledProfiles.contains(m_contentBlockingProfiles.at(i)->getName()))
+			{
+				m_contentBlockingProfiles.at(i)->load();
+			}
+		}
+	}
 }
 
 void ContentFiltersManager::timerEvent(QTimerEvent *event)
@@ -212,6 +265,101 @@ void ContentFiltersManager::scheduleSave()
 	}
 }
 
+void ContentFiltersManager::clearCaches()
+{
+	m_checkResultsCacheGeneration.ref();
+
+	for (int i = 0; i < CheckResultsCacheShardsAmount; ++i)
+	{
+		QMutexLocker locker(&m_checkResultsCacheShards[i].mutex);
+
+		m_checkResultsCacheShards[i].results.clear();
+	}
+
+	QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+
+	m_cosmeticFiltersStyleSheetsCache.clear();
+	m_genericCosmeticFilters.clear();
+}
+
+void ContentFiltersManager::createMergedMatcher(const QVector<int> &profiles, int revision)
+{
+	const QString key(createProfilesKey(profiles));
+	const int generation(m_checkResultsCacheGeneration.loadAcquire());
+
+	{
+		QReadLocker locker(&m_mergedMatchersLock);
+
+		if (m_pendingMergedMatchers.value(key, -1) != revision)
+		{
+			return;
+		}
+	}
+
+	QVector<QSharedPointer<const AdblockContentFiltersMatcher> > matchers;
+	matchers.reserve(profiles.count());
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const int index(profiles.at(i));
+		AdblockContentFiltersProfile *profile((index >= 0 && index < m_contentBlockingProfiles.count()) ? qobject_cast<AdblockContentFiltersProfile*>(m_contentBlockingProfiles.at(index)) : nullptr);
+		const QSharedPointer<const AdblockContentFiltersMatcher> matcher(profile ? profile->getMatcher() : QSharedPointer<const AdblockContentFiltersMatcher>());
+
+		if (!matcher)
+		{
+			publishMergedMatcher(key, {}, generation, revision);
+
+			return;
+		}
+
+		matchers.append(matcher);
+	}
+
+	QFutureWatcher<AdblockContentFiltersMatcher*> *watcher(new QFutureWatcher<AdblockContentFiltersMatcher*>(m_instance));
+
+	connect(watcher, &QFutureWatcher<AdblockContentFiltersMatcher*>::finished, m_instance, [=]()
+	{
+		publishMergedMatcher(key, QSharedPointer<AdblockContentFiltersMatcher>(watcher->result()), generation, revision);
+
+		watcher->deleteLater();
+	});
+
+	watcher->setFuture(QtConcurrent::run([=]() -> AdblockContentFiltersMatcher*
+	{
+		AdblockContentFiltersMatcher *matcher(new AdblockContentFiltersMatcher());
+
+		for (int i = 0; i < matchers.count(); ++i)
+		{
+			matcher->addRules(*matchers.at(i), profiles.at(i));
+		}
+
+		matcher->compile();
+
+		return matcher;
+	}));
+}
+
+void ContentFiltersManager::publishMergedMatcher(const QString &key, const QSharedPointer<AdblockContentFiltersMatcher> &matcher, int generation, int revision)
+{
+	QWriteLocker locker(&m_mergedMatchersLock);
+
+	if (m_pendingMergedMatchers.value(key, -1) != revision)
+	{
+		return;
+	}
+
+	MergedMatcher mergedMatcher(m_mergedMatchers.value(key));
+	mergedMatcher.generation = generation;
+
+	if (matcher)
+	{
+		mergedMatcher.matcher = matcher;
+	}
+
+	m_pendingMergedMatchers.remove(key);
+	m_mergedMatchers.insert(key, mergedMatcher);
+}
+
 void ContentFiltersManager::save()
 {
 	const QHash<ContentFiltersProfile::ProfileCategory, QString> categories({{ContentFiltersProfile::AdvertisementsCategory, QLatin1String("advertisements")}, {ContentFiltersProfile::AnnoyanceCategory, QLatin1String("annoyance")}, {ContentFiltersProfile::PrivacyCategory, QLatin1String("privacy")}, {ContentFiltersProfile::SocialCategory, QLatin1String("social")}, {ContentFiltersProfile::RegionalCategory, QLatin1String("regional")}, {ContentFiltersProfile::OtherCategory, QLatin1String("other")}});
@@ -258,6 +406,18 @@ void ContentFiltersManager::save()
 			profileObject.insert(QLatin1String("lastUpdate"), lastUpdate.toString(Qt::ISODate));
 		}
 
+		const ContentFiltersProfile::ProfileSummary profileSummary(profile->getProfileSummary());
+
+		if (!profileSummary.entityTag.isEmpty())
+		{
+			profileObject.insert(QLatin1String("entityTag"), QString::fromLatin1(profileSummary.entityTag));
+		}
+
+		if (!profileSummary.lastModified.isEmpty())
+		{
+			profileObject.insert(QLatin1String("lastModified"), QString::fromLatin1(profileSummary.lastModified));
+		}
+
 		if (profile->getFlags().testFlag(ContentFiltersProfile::HasCustomTitleFlag))
 		{
 			profileObject.insert(QLatin1String("title"), profile->getTitle());
@@ -321,6 +481,9 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 	emit m_instance->profileAdded(profile->getName());
 
 	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::scheduleSave);
+	connect(profile, &ContentFiltersProfile::rulesModified, m_instance, &ContentFiltersManager::clearCaches);
+
+	clearCaches();
 }
 
 void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool removeFile)
@@ -354,8 +517,17 @@ void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool r
 
 	m_contentBlockingProfiles.removeAll(profile);
 
+	{
+		QWriteLocker locker(&m_mergedMatchersLock);
+
+		m_mergedMatchers.clear();
+		m_pendingMergedMatchers.clear();
+	}
+
 	profile->deleteLater();
 
+	clearCaches();
+
 	emit m_instance->profileRemoved(name);
 }
 
@@ -418,33 +590,121 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 		return {};
 	}
 
+	const QString profilesKey(createProfilesKey(profiles));
+	const QString key(QString::number(resourceType) + QLatin1Char(' ') + baseUrl.host() + QLatin1Char(' ') + requestUrl.toString() + QLatin1Char(' ') + profilesKey);
+	const int generation(m_checkResultsCacheGeneration.loadAcquire());
+	CheckResultsCacheShard &shard(m_checkResultsCacheShards[qHash(key) % CheckResultsCacheShardsAmount]);
+
+	{
+		QMutexLocker locker(&shard.mutex);
+		const CheckResult *cachedResult(shard.results.object(key));
+
+		if (cachedResult)
+		{
+			++shard.hits;
+
+			return *cachedResult;
+		}
+
+		++shard.misses;
+	}
+
 	CheckResult result;
 	result.isFraud = ((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
 
-	for (int i = 0; i < profiles.count(); ++i)
+	const MergedMatcher mergedMatcher((m_areProfilesMerged && profiles.count() > 1) ? getMergedMatcher(profiles, profilesKey) : MergedMatcher());
+
+	if (mergedMatcher.matcher)
 	{
-		const int profile(profiles.at(i));
+		const bool isFraud(result.isFraud);
 
-		if (profile < 0 || profile >= m_contentBlockingProfiles.count())
+		result = mergedMatcher.matcher->checkUrl(AdblockContentFiltersMatcher::Request(baseUrl, requestUrl, resourceType));
+		result.isFraud = isFraud;
+	}
+	else
+	{
+		for (int i = 0; i < profiles.count(); ++i)
 		{
-			continue;
+			const int profile(profiles.at(i));
+
+			if (profile < 0 || profile >= m_contentBlockingProfiles.count())
+			{
+				continue;
+			}
+
+			CheckResult currentResult(m_contentBlockingProfiles.at(profile)->checkUrl(baseUrl, requestUrl, resourceType));
+			currentResult.profile = profile;
+			currentResult.isFraud = result.isFraud;
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				result = currentResult;
+
+				break;
+			}
 		}
+	}
+
+	QMutexLocker locker(&shard.mutex);
+
+	if (generation == m_checkResultsCacheGeneration.loadAcquire() && (!mergedMatcher.matcher || mergedMatcher.generation == generation))
+	{
+		shard.results.insert(key, new CheckResult(result));
+	}
+
+	return result;
+}
+
+QVector<ContentFiltersManager::CheckResult> ContentFiltersManager::checkUrls(const QVector<int> &profiles, const QVector<CheckRequest> &requests, bool canUseThreads)
+{
+	QVector<CheckResult> results(requests.count());
 
-		CheckResult currentResult(m_contentBlockingProfiles.at(profile)->checkUrl(baseUrl, requestUrl, resourceType));
-		currentResult.profile = profile;
-		currentResult.isFraud = result.isFraud;
+	if (requests.isEmpty())
+	{
+		return results;
+	}
 
-		if (currentResult.isBlocked)
+	CheckResult *data(results.data());
+	const int shardsAmount(canUseThreads ? qBound(1, QThread::idealThreadCount(), requests.count()) : 1);
+
+	if (shardsAmount == 1)
+	{
+		for (int i = 0; i < requests.count(); ++i)
 		{
-			result = currentResult;
+			const CheckRequest &request(requests.at(i));
+
+			data[i] = checkUrl(profiles, request.baseUrl, request.requestUrl, request.resourceType);
 		}
-		else if (currentResult.isException)
+
+		return results;
+	}
+
+	QVector<QFuture<void> > futures;
+	futures.reserve(shardsAmount);
+
+	for (int i = 0; i < shardsAmount; ++i)
+	{
+		futures.append(QtConcurrent::run([=]()
 		{
-			return currentResult;
-		}
+			for (int j = i; j < requests.count(); j += shardsAmount)
+			{
+				const CheckRequest &request(requests.at(j));
+
+				data[j] = checkUrl(profiles, request.baseUrl, request.requestUrl, request.resourceType);
+			}
+		}));
 	}
 
-	return result;
+	for (int i = 0; i < futures.count(); ++i)
+	{
+		futures[i].waitForFinished();
+	}
+
+	return results;
 }
 
 ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl)
@@ -480,6 +740,252 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 	return result;
 }
 
+ContentFiltersManager::CosmeticFiltersStyleSheet ContentFiltersManager::getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl)
+{
+	if (profiles.isEmpty())
+	{
+		return {};
+	}
+
+	const CosmeticFiltersMode mode(checkUrl(profiles, requestUrl, requestUrl, NetworkManager::OtherType).comesticFiltersMode);
+	const QString key(createProfilesKey(profiles) + QLatin1Char(' ') + QString::number(mode) + QLatin1Char(' ') + requestUrl.host());
+
+	{
+		QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+		const CosmeticFiltersStyleSheet *cachedStyleSheet(m_cosmeticFiltersStyleSheetsCache.object(key));
+
+		if (cachedStyleSheet)
+		{
+			return *cachedStyleSheet;
+		}
+	}
+
+	CosmeticFiltersStyleSheet result;
+
+	if (mode == NoFilters)
+	{
+		result.isOverridingGenericStyleSheet = true;
+	}
+	else
+	{
+		const QStringList domains(createSubdomainList(requestUrl.host()));
+		QStringList rules;
+		QSet<QString> exceptions;
+
+		for (int i = 0; i < profiles.count(); ++i)
+		{
+			const int index(profiles.at(i));
+
+			if (index >= 0 && index < m_contentBlockingProfiles.count())
+			{
+				const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, true));
+
+				rules.append(profileResult.rules);
+
+				for (int j = 0; j < profileResult.exceptions.count(); ++j)
+				{
+					exceptions.insert(profileResult.exceptions.at(j));
+				}
+			}
+		}
+
+		if (!exceptions.isEmpty())
+		{
+			for (int i = (rules.count() - 1); i >= 0; --i)
+			{
+				if (exceptions.contains(rules.at(i)))
+				{
+					rules.removeAt(i);
+				}
+			}
+		}
+
+		result.styleSheet = createStyleSheet(rules);
+
+		if (mode == DomainOnlyFilters)
+		{
+			result.isOverridingGenericStyleSheet = true;
+		}
+		else if (!exceptions.isEmpty())
+		{
+			getGenericCosmeticFiltersStyleSheet(profiles);
+
+			QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+			const GenericCosmeticFilters genericFilters(m_genericCosmeticFilters.value(createProfilesKey(profiles)));
+			QSet<QString>::const_iterator iterator;
+
+			for (iterator = exceptions.constBegin(); iterator != exceptions.constEnd(); ++iterator)
+			{
+				if (genericFilters.selectorsSet.contains(*iterator))
+				{
+					result.isOverridingGenericStyleSheet = true;
+
+					break;
+				}
+			}
+
+			if (result.isOverridingGenericStyleSheet)
+			{
+				QStringList selectors(genericFilters.selectors);
+
+				for (int i = (selectors.count() - 1); i >= 0; --i)
+				{
+					if (exceptions.contains(selectors.at(i)))
+					{
+						selectors.removeAt(i);
+					}
+				}
+
+				result.genericStyleSheet = createStyleSheet(selectors);
+			}
+		}
+	}
+
+	QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+
+	m_cosmeticFiltersStyleSheetsCache.insert(key, new CosmeticFiltersStyleSheet(result));
+
+	return result;
+}
+
+QString ContentFiltersManager::getGenericCosmeticFiltersStyleSheet(const QVector<int> &profiles)
+{
+	if (profiles.isEmpty())
+	{
+		return {};
+	}
+
+	const QString key(createProfilesKey(profiles));
+
+	{
+		QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+
+		if (m_genericCosmeticFilters.contains(key))
+		{
+			return m_genericCosmeticFilters[key].styleSheet;
+		}
+	}
+
+	GenericCosmeticFilters genericFilters;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const int index(profiles.at(i));
+
+		if (index >= 0 && index < m_contentBlockingProfiles.count())
+		{
+			genericFilters.selectors.append(m_contentBlockingProfiles.at(index)->getCosmeticFilters({}, false).rules);
+		}
+	}
+
+	genericFilters.selectors.removeDuplicates();
+	genericFilters.selectorsSet.reserve(genericFilters.selectors.count());
+
+	for (int i = 0; i < genericFilters.selectors.count(); ++i)
+	{
+		genericFilters.selectorsSet.insert(genericFilters.selectors.at(i));
+	}
+
+	genericFilters.styleSheet = createStyleSheet(genericFilters.selectors);
+
+	QMutexLocker locker(&m_cosmeticFiltersCachesMutex);
+
+	m_genericCosmeticFilters[key] = genericFilters;
+
+	return genericFilters.styleSheet;
+}
+
+ContentFiltersManager::MergedMatcher ContentFiltersManager::getMergedMatcher(const QVector<int> &profiles, const QString &key)
+{
+	const int generation(m_checkResultsCacheGeneration.loadAcquire());
+
+	{
+		QReadLocker locker(&m_mergedMatchersLock);
+		const MergedMatcher mergedMatcher(m_mergedMatchers.value(key));
+
+		if (mergedMatcher.generation == generation || m_pendingMergedMatchers.contains(key))
+		{
+			return mergedMatcher;
+		}
+	}
+
+	QWriteLocker locker(&m_mergedMatchersLock);
+	const MergedMatcher mergedMatcher(m_mergedMatchers.value(key));
+
+	if (mergedMatcher.generation != generation && !m_pendingMergedMatchers.contains(key))
+	{
+		const int revision(++m_mergedMatchersRevision);
+
+		m_pendingMergedMatchers.insert(key, revision);
+
+		QMetaObject::invokeMethod(m_instance, [=]()
+		{
+			createMergedMatcher(profiles, revision);
+		}, Qt::QueuedConnection);
+	}
+
+	return mergedMatcher;
+}
+
+ContentFiltersManager::CheckResultsCacheStatistics ContentFiltersManager::getCheckResultsCacheStatistics()
+{
+	CheckResultsCacheStatistics statistics;
+
+	for (int i = 0; i < CheckResultsCacheShardsAmount; ++i)
+	{
+		QMutexLocker locker(&m_checkResultsCacheShards[i].mutex);
+
+		statistics.hits += m_checkResultsCacheShards[i].hits;
+		statistics.misses += m_checkResultsCacheShards[i].misses;
+		statistics.size += m_checkResultsCacheShards[i].results.size();
+	}
+
+	return statistics;
+}
+
+DiagnosticReport::Section ContentFiltersManager::createReport()
+{
+	const CheckResultsCacheStatistics statistics(getCheckResultsCacheStatistics());
+	DiagnosticReport::Section report;
+	report.title = QLatin1String("Content Blocking");
+	report.fieldWidths = {30, 0};
+	report.entries.reserve(3);
+	report.entries.append({QLatin1String("Decisions Cache Size"), QString::number(statistics.size)});
+	report.entries.append({QLatin1String("Decisions Cache Hits"), QString::number(statistics.hits)});
+	report.entries.append({QLatin1String("Decisions Cache Misses"), QString::number(statistics.misses)});
+
+	return report;
+}
+
+QString ContentFiltersManager::createStyleSheet(const QStringList &selectors)
+{
+	QString styleSheet;
+
+	for (int i = 0; i < selectors.count(); ++i)
+	{
+		const QString &selector(selectors.at(i));
+
+		if (!selector.isEmpty() && !selector.contains(QLatin1Char('{')) && !selector.contains(QLatin1Char('}')))
+		{
+			styleSheet.append(selector + QLatin1String(" {display:none !important;}\n"));
+		}
+	}
+
+	return styleSheet;
+}
+
+QString ContentFiltersManager::createProfilesKey(const QVector<int> &profiles)
+{
+	QString key;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		key.append(QString::number(profiles.at(i)) + QLatin1Char(','));
+	}
+
+	return key;
+}
+
 QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
 {
 	QStringList subdomainList;
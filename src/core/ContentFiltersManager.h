@@ -22,12 +22,19 @@
 #define OTTER_CONTENTFILTERSMANAGER_H
 
 #include "NetworkManager.h"
+#include "Utils.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QUrl>
 
 namespace Otter
 {
 
+class AdblockContentFiltersMatcher;
 class ContentFiltersProfile;
 
 class ContentFiltersManager final : public QObject
@@ -42,6 +49,13 @@ public:
 		AllFilters
 	};
 
+	struct CheckRequest final
+	{
+		QUrl baseUrl;
+		QUrl requestUrl;
+		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+	};
+
 	struct CheckResult final
 	{
 		QString rule;
@@ -58,6 +72,20 @@ public:
 		QStringList exceptions;
 	};
 
+	struct CosmeticFiltersStyleSheet final
+	{
+		QString styleSheet;
+		QString genericStyleSheet;
+		bool isOverridingGenericStyleSheet = false;
+	};
+
+	struct CheckResultsCacheStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+		int size = 0;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void addProfile(ContentFiltersProfile *profile);
@@ -67,7 +95,12 @@ public:
 	static ContentFiltersProfile* getProfile(const QUrl &url);
 	static ContentFiltersProfile* getProfile(int identifier);
 	static CheckResult checkUrl(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
+	static QVector<CheckResult> checkUrls(const QVector<int> &profiles, const QVector<CheckRequest> &requests, bool canUseThreads = false);
 	static CosmeticFiltersResult getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl);
+	static CosmeticFiltersStyleSheet getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl);
+	static QString getGenericCosmeticFiltersStyleSheet(const QVector<int> &profiles);
+	static CheckResultsCacheStatistics getCheckResultsCacheStatistics();
+	static DiagnosticReport::Section createReport();
 	static QStringList createSubdomainList(const QString &domain);
 	static QStringList getProfileNames();
 	static QVector<ContentFiltersProfile*> getContentBlockingProfiles();
@@ -76,10 +109,43 @@ public:
 	static bool isFraud(const QUrl &url);
 
 protected:
+	enum CheckResultsCacheInformation
+	{
+		CheckResultsCacheShardsAmount = 16,
+		CheckResultsCacheShardSize = 64
+	};
+
+	struct CheckResultsCacheShard final
+	{
+		QCache<QString, CheckResult> results;
+		QMutex mutex;
+		quint64 hits = 0;
+		quint64 misses = 0;
+	};
+
+	struct GenericCosmeticFilters final
+	{
+		QString styleSheet;
+		QStringList selectors;
+		QSet<QString> selectorsSet;
+	};
+
+	struct MergedMatcher final
+	{
+		QSharedPointer<AdblockContentFiltersMatcher> matcher;
+		int generation = -1;
+	};
+
 	explicit ContentFiltersManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	void save();
+	static void clearCaches();
+	static void createMergedMatcher(const QVector<int> &profiles, int revision);
+	static void publishMergedMatcher(const QString &key, const QSharedPointer<AdblockContentFiltersMatcher> &matcher, int generation, int revision);
+	static MergedMatcher getMergedMatcher(const QVector<int> &profiles, const QString &key);
+	static QString createStyleSheet(const QStringList &selectors);
+	static QString createProfilesKey(const QVector<int> &profiles);
 
 protected slots:
 	void scheduleSave();
@@ -90,6 +156,16 @@ private:
 	static ContentFiltersManager *m_instance;
 	static QVector<ContentFiltersProfile*> m_contentBlockingProfiles;
 	static QVector<ContentFiltersProfile*> m_fraudCheckingProfiles;
+	static QCache<QString, CosmeticFiltersStyleSheet> m_cosmeticFiltersStyleSheetsCache;
+	static QHash<QString, GenericCosmeticFilters> m_genericCosmeticFilters;
+	static QHash<QString, MergedMatcher> m_mergedMatchers;
+	static QHash<QString, int> m_pendingMergedMatchers;
+	static CheckResultsCacheShard m_checkResultsCacheShards[CheckResultsCacheShardsAmount];
+	static QMutex m_cosmeticFiltersCachesMutex;
+	static QReadWriteLock m_mergedMatchersLock;
+	static QAtomicInt m_checkResultsCacheGeneration;
+	static int m_mergedMatchersRevision;
+	static bool m_areProfilesMerged;
 
 signals:
 	void profileAdded(const QString &profile);
@@ -132,6 +208,8 @@ public:
 	{
 		QString name;
 		QString title;
+		QByteArray entityTag;
+		QByteArray lastModified;
 		QDateTime lastUpdate;
 		QUrl updateUrl;
 		ProfileCategory category = OtherCategory;
@@ -143,6 +221,7 @@ public:
 	explicit ContentFiltersProfile(QObject *parent = nullptr);
 
 	virtual void clear() = 0;
+	virtual void load() = 0;
 	virtual void setProfileSummary(const ProfileSummary &profileSummary) = 0;
 	virtual QString getName() const = 0;
 	virtual QString getTitle() const = 0;
@@ -167,6 +246,7 @@ public:
 
 signals:
 	void profileModified();
+	void rulesModified();
 	void updateProgressChanged(int progress);
 };
 
@@ -0,0 +1,586 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FaviconsStore.h"
+#include "Console.h"
+#include "SessionsManager.h"
+#include "Utils.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtGui/QPixmap>
+
+namespace Otter
+{
+
+const quint32 FaviconsStore::StoreMagic(0x4F464943);
+const quint32 FaviconsStore::StoreVersion(2);
+const qint64 FaviconsStore::IconUrlLifetime(2592000);
+
+FaviconsStore::FaviconsStore(const QString &path) :
+	m_path(path),
+	m_icons(256),
+	m_nextIconIdentifier(1),
+	m_obsoleteRecordsAmount(0),
+	m_needsCompaction(false)
+{
+	load();
+}
+
+void FaviconsStore::load()
+{
+	QFile file(m_path);
+
+	if (!file.exists())
+	{
+		return;
+	}
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open favicons file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	quint32 magic(0);
+	quint32 version(0);
+
+	stream >> magic >> version;
+
+	if (magic != StoreMagic || version == 0 || version > StoreVersion)
+	{
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	const qint64 time(QDateTime::currentSecsSinceEpoch());
+
+	while (!stream.atEnd())
+	{
+		quint8 type(UnknownRecord);
+
+		stream >> type;
+
+		switch (type)
+		{
+			case IconRecord:
+				{
+					quint32 identifier(0);
+					QByteArray data;
+
+					stream >> identifier >> data;
+
+					if (stream.status() == QDataStream::Ok && identifier > 0)
+					{
+						m_iconsData[identifier] = data;
+						m_checksums[QCryptographicHash::hash(data, QCryptographicHash::Sha1)] = identifier;
+						m_nextIconIdentifier = qMax(m_nextIconIdentifier, (identifier + 1));
+					}
+				}
+
+				break;
+			case HostRecord:
+				{
+					QString host;
+					quint32 identifier(0);
+
+					stream >> host >> identifier;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						if (m_hosts.contains(host))
+						{
+							++m_obsoleteRecordsAmount;
+						}
+
+						if (identifier == 0)
+						{
+							m_hosts.remove(host);
+
+							++m_obsoleteRecordsAmount;
+						}
+						else
+						{
+							m_hosts[host] = identifier;
+						}
+					}
+				}
+
+				break;
+			case UrlRecord:
+				{
+					QUrl url;
+					quint32 identifier(0);
+
+					stream >> url >> identifier;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						if (m_urls.contains(url))
+						{
+							++m_obsoleteRecordsAmount;
+						}
+
+						if (identifier == 0)
+						{
+							m_urls.remove(url);
+
+							++m_obsoleteRecordsAmount;
+						}
+						else
+						{
+							m_urls[url] = identifier;
+						}
+					}
+				}
+
+				break;
+			case IconUrlRecord:
+				{
+					QUrl url;
+					IconUrlEntry entry;
+
+					stream >> url >> entry.identifier >> entry.time;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						if (m_iconUrls.contains(url))
+						{
+							++m_obsoleteRecordsAmount;
+						}
+
+						if (entry.identifier == 0 || (time - entry.time) > IconUrlLifetime)
+						{
+							m_iconUrls.remove(url);
+
+							++m_obsoleteRecordsAmount;
+						}
+						else
+						{
+							m_iconUrls[url] = entry;
+						}
+					}
+				}
+
+				break;
+			default:
+				stream.setStatus(QDataStream::ReadCorruptData);
+
+				break;
+		}
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			m_needsCompaction = true;
+
+			break;
+		}
+	}
+}
+
+void FaviconsStore::clear()
+{
+	m_pendingRecords.clear();
+	m_icons.clear();
+	m_iconsData.clear();
+	m_checksums.clear();
+	m_cacheKeys.clear();
+	m_hosts.clear();
+	m_urls.clear();
+	m_iconUrls.clear();
+
+	m_needsCompaction = true;
+}
+
+void FaviconsStore::setIcon(const QUrl &url, const QIcon &icon, bool isHostIcon)
+{
+	if (icon.isNull() || !url.isValid())
+	{
+		return;
+	}
+
+	const quint32 identifier(addIcon(icon));
+
+	if (identifier == 0)
+	{
+		return;
+	}
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+	if (!isHostIcon)
+	{
+		if (m_iconUrls.contains(normalizedUrl))
+		{
+			++m_obsoleteRecordsAmount;
+		}
+
+		IconUrlEntry entry;
+		entry.identifier = identifier;
+		entry.time = QDateTime::currentSecsSinceEpoch();
+
+		m_iconUrls[normalizedUrl] = entry;
+
+		stream << static_cast<quint8>(IconUrlRecord) << normalizedUrl << entry.identifier << entry.time;
+
+		return;
+	}
+
+	const QString host(Utils::extractHost(url));
+
+	if (!host.isEmpty() && m_hosts.value(host) != identifier)
+	{
+		if (m_hosts.contains(host))
+		{
+			++m_obsoleteRecordsAmount;
+		}
+
+		m_hosts[host] = identifier;
+
+		stream << static_cast<quint8>(HostRecord) << host << identifier;
+	}
+
+	if (m_hosts.value(host) == identifier)
+	{
+		if (m_urls.contains(normalizedUrl))
+		{
+			m_urls.remove(normalizedUrl);
+
+			stream << static_cast<quint8>(UrlRecord) << normalizedUrl << static_cast<quint32>(0);
+
+			m_obsoleteRecordsAmount += 2;
+		}
+
+		return;
+	}
+
+	if (m_urls.value(normalizedUrl) != identifier)
+	{
+		if (m_urls.contains(normalizedUrl))
+		{
+			++m_obsoleteRecordsAmount;
+		}
+
+		m_urls[normalizedUrl] = identifier;
+
+		stream << static_cast<quint8>(UrlRecord) << normalizedUrl << identifier;
+	}
+}
+
+void FaviconsStore::removeIcons(const QVector<QUrl> &urls, const QStringList &hosts)
+{
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		if (m_urls.remove(urls.at(i)) > 0)
+		{
+			stream << static_cast<quint8>(UrlRecord) << urls.at(i) << static_cast<quint32>(0);
+
+			m_obsoleteRecordsAmount += 2;
+		}
+	}
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		if (m_hosts.remove(hosts.at(i)) > 0)
+		{
+			stream << static_cast<quint8>(HostRecord) << hosts.at(i) << static_cast<quint32>(0);
+
+			m_obsoleteRecordsAmount += 2;
+		}
+	}
+}
+
+void FaviconsStore::writeIcon(QDataStream &stream, quint32 identifier) const
+{
+	stream << static_cast<quint8>(IconRecord) << identifier << m_iconsData.value(identifier);
+}
+
+QIcon FaviconsStore::createIcon(quint32 identifier)
+{
+	if (identifier == 0)
+	{
+		return {};
+	}
+
+	if (m_icons.contains(identifier))
+	{
+		return *m_icons.object(identifier);
+	}
+
+	if (!m_iconsData.contains(identifier))
+	{
+		return {};
+	}
+
+	QPixmap pixmap;
+
+	if (!pixmap.loadFromData(m_iconsData.value(identifier)))
+	{
+		return {};
+	}
+
+	const QIcon icon(pixmap);
+
+	m_icons.insert(identifier, new QIcon(icon));
+	m_cacheKeys[icon.cacheKey()] = identifier;
+
+	return icon;
+}
+
+QIcon FaviconsStore::getIcon(const QString &host)
+{
+	return createIcon(m_hosts.value(host));
+}
+
+QIcon FaviconsStore::getIcon(const QUrl &url, bool isExact)
+{
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+	if (isExact)
+	{
+		const IconUrlEntry entry(m_iconUrls.value(normalizedUrl));
+
+		return (((QDateTime::currentSecsSinceEpoch() - entry.time) > IconUrlLifetime) ? QIcon() : createIcon(entry.identifier));
+	}
+
+	if (m_urls.contains(normalizedUrl))
+	{
+		return createIcon(m_urls.value(normalizedUrl));
+	}
+
+	return (isExact ? QIcon() : createIcon(m_hosts.value(Utils::extractHost(url))));
+}
+
+quint32 FaviconsStore::addIcon(const QIcon &icon)
+{
+	if (m_cacheKeys.contains(icon.cacheKey()))
+	{
+		return m_cacheKeys.value(icon.cacheKey());
+	}
+
+	const QList<QSize> sizes(icon.availableSizes());
+	QSize size(icon.actualSize(QSize(32, 32)));
+
+	for (int i = 0; i < sizes.count(); ++i)
+	{
+		if (sizes.at(i).width() <= 64 && sizes.at(i).width() > size.width())
+		{
+			size = sizes.at(i);
+		}
+	}
+
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+
+	if (!icon.pixmap(size).save(&buffer, "PNG"))
+	{
+		return 0;
+	}
+
+	const QByteArray checksum(QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+	quint32 identifier(m_checksums.value(checksum));
+
+	if (identifier == 0)
+	{
+		identifier = m_nextIconIdentifier;
+
+		++m_nextIconIdentifier;
+
+		m_iconsData[identifier] = data;
+		m_checksums[checksum] = identifier;
+
+		QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+		stream.setVersion(QDataStream::Qt_5_15);
+
+		writeIcon(stream, identifier);
+	}
+
+	if (m_cacheKeys.count() > 4096)
+	{
+		m_cacheKeys.clear();
+	}
+
+	m_cacheKeys[icon.cacheKey()] = identifier;
+
+	return identifier;
+}
+
+bool FaviconsStore::compact()
+{
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save favicons file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	QSet<quint32> identifiers;
+	QHash<QString, quint32>::const_iterator hostsIterator;
+	QHash<QUrl, quint32>::const_iterator urlsIterator;
+
+	for (hostsIterator = m_hosts.constBegin(); hostsIterator != m_hosts.constEnd(); ++hostsIterator)
+	{
+		identifiers.insert(hostsIterator.value());
+	}
+
+	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	{
+		identifiers.insert(urlsIterator.value());
+	}
+
+	const qint64 time(QDateTime::currentSecsSinceEpoch());
+	QHash<QUrl, IconUrlEntry>::iterator iconUrlsIterator(m_iconUrls.begin());
+
+	while (iconUrlsIterator != m_iconUrls.end())
+	{
+		if ((time - iconUrlsIterator->time) > IconUrlLifetime)
+		{
+			iconUrlsIterator = m_iconUrls.erase(iconUrlsIterator);
+		}
+		else
+		{
+			identifiers.insert(iconUrlsIterator->identifier);
+
+			++iconUrlsIterator;
+		}
+	}
+
+	const QList<quint32> storedIdentifiers(m_iconsData.keys());
+
+	for (int i = 0; i < storedIdentifiers.count(); ++i)
+	{
+		if (!identifiers.contains(storedIdentifiers.at(i)))
+		{
+			m_checksums.remove(QCryptographicHash::hash(m_iconsData.take(storedIdentifiers.at(i)), QCryptographicHash::Sha1));
+			m_icons.remove(storedIdentifiers.at(i));
+		}
+	}
+
+	QHash<qint64, quint32>::iterator cacheKeysIterator(m_cacheKeys.begin());
+
+	while (cacheKeysIterator != m_cacheKeys.end())
+	{
+		if (identifiers.contains(cacheKeysIterator.value()))
+		{
+			++cacheKeysIterator;
+		}
+		else
+		{
+			cacheKeysIterator = m_cacheKeys.erase(cacheKeysIterator);
+		}
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << StoreMagic << StoreVersion;
+
+	QHash<quint32, QByteArray>::const_iterator iconsIterator;
+
+	for (iconsIterator = m_iconsData.constBegin(); iconsIterator != m_iconsData.constEnd(); ++iconsIterator)
+	{
+		writeIcon(stream, iconsIterator.key());
+	}
+
+	for (hostsIterator = m_hosts.constBegin(); hostsIterator != m_hosts.constEnd(); ++hostsIterator)
+	{
+		stream << static_cast<quint8>(HostRecord) << hostsIterator.key() << hostsIterator.value();
+	}
+
+	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	{
+		stream << static_cast<quint8>(UrlRecord) << urlsIterator.key() << urlsIterator.value();
+	}
+
+	for (iconUrlsIterator = m_iconUrls.begin(); iconUrlsIterator != m_iconUrls.end(); ++iconUrlsIterator)
+	{
+		stream << static_cast<quint8>(IconUrlRecord) << iconUrlsIterator.key() << iconUrlsIterator->identifier << iconUrlsIterator->time;
+	}
+
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	m_pendingRecords.clear();
+
+	m_obsoleteRecordsAmount = 0;
+	m_needsCompaction = false;
+
+	return true;
+}
+
+bool FaviconsStore::flush()
+{
+	if (SessionsManager::isReadOnly())
+	{
+		return false;
+	}
+
+	if (m_needsCompaction || !QFile::exists(m_path) || (m_obsoleteRecordsAmount > 256 && m_obsoleteRecordsAmount > (m_hosts.count() + m_urls.count() + m_iconUrls.count())))
+	{
+		return compact();
+	}
+
+	if (m_pendingRecords.isEmpty())
+	{
+		return true;
+	}
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save favicons file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	if (file.write(m_pendingRecords) != m_pendingRecords.size())
+	{
+		m_needsCompaction = true;
+
+		return false;
+	}
+
+	m_pendingRecords.clear();
+
+	return true;
+}
+
+}
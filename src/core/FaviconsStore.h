@@ -0,0 +1,87 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FAVICONSSTORE_H
+#define OTTER_FAVICONSSTORE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+#include <QtGui/QIcon>
+
+namespace Otter
+{
+
+class FaviconsStore final
+{
+public:
+	explicit FaviconsStore(const QString &path);
+
+	void clear();
+	void setIcon(const QUrl &url, const QIcon &icon, bool isHostIcon = true);
+	void removeIcons(const QVector<QUrl> &urls, const QStringList &hosts);
+	QIcon getIcon(const QString &host);
+	QIcon getIcon(const QUrl &url, bool isExact = false);
+	bool flush();
+
+protected:
+	enum RecordType
+	{
+		UnknownRecord = 0,
+		IconRecord,
+		HostRecord,
+		UrlRecord,
+		IconUrlRecord
+	};
+
+	struct IconUrlEntry final
+	{
+		qint64 time = 0;
+		quint32 identifier = 0;
+	};
+
+	void load();
+	void writeIcon(QDataStream &stream, quint32 identifier) const;
+	QIcon createIcon(quint32 identifier);
+	quint32 addIcon(const QIcon &icon);
+	bool compact();
+
+private:
+	QString m_path;
+	QByteArray m_pendingRecords;
+	QCache<quint32, QIcon> m_icons;
+	QHash<quint32, QByteArray> m_iconsData;
+	QHash<QByteArray, quint32> m_checksums;
+	QHash<qint64, quint32> m_cacheKeys;
+	QHash<QString, quint32> m_hosts;
+	QHash<QUrl, quint32> m_urls;
+	QHash<QUrl, IconUrlEntry> m_iconUrls;
+	quint32 m_nextIconIdentifier;
+	int m_obsoleteRecordsAmount;
+	bool m_needsCompaction;
+
+	static const quint32 StoreMagic;
+	static const quint32 StoreVersion;
+	static const qint64 IconUrlLifetime;
+};
+
+}
+
+#endif
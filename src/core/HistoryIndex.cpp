@@ -0,0 +1,339 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryIndex.h"
+
+#include <QtCore/QSet>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+HistoryIndex::HistoryIndex() :
+	m_invalidSlotsAmount(0)
+{
+}
+
+void HistoryIndex::clear()
+{
+	m_slots.clear();
+	m_entries.clear();
+	m_pendingEntries.clear();
+	m_urls.clear();
+	m_trigrams.clear();
+
+	m_invalidSlotsAmount = 0;
+}
+
+void HistoryIndex::addUrl(const QUrl &url, const QString &title, bool canOptimize)
+{
+	if (m_urls.contains(url))
+	{
+		setTitle(url, title);
+
+		return;
+	}
+
+	const int slot(m_slots.count());
+	Slot slotData;
+	slotData.url = url;
+	slotData.text = url.toString().toLower();
+	slotData.title = title.toLower();
+	slotData.isValid = true;
+
+	m_slots.append(slotData);
+	m_urls[url] = slot;
+
+	PrefixEntry entry;
+	entry.slot = slot;
+
+	m_pendingEntries.append(entry);
+
+	const QString authority(url.toString(QUrl::RemoveScheme).mid(2).toLower());
+
+	if (!authority.isEmpty() && authority.length() < slotData.text.length() && slotData.text.endsWith(authority))
+	{
+		entry.offset = (slotData.text.length() - authority.length());
+
+		m_pendingEntries.append(entry);
+
+		if (authority.startsWith(QLatin1String("www.")) && url.host().count(QLatin1Char('.')) > 1)
+		{
+			entry.offset += 4;
+
+			m_pendingEntries.append(entry);
+		}
+	}
+
+	addTrigrams(slot, slotData.text);
+	addTrigrams(slot, slotData.title);
+
+	if (canOptimize && m_pendingEntries.count() > 512)
+	{
+		optimize();
+	}
+}
+
+void HistoryIndex::removeUrl(const QUrl &url)
+{
+	if (!m_urls.contains(url))
+	{
+		return;
+	}
+
+	m_slots[m_urls.take(url)].isValid = false;
+
+	++m_invalidSlotsAmount;
+
+	if (m_invalidSlotsAmount > 1024 && m_invalidSlotsAmount > m_urls.count())
+	{
+		const QVector<Slot> previousSlots(m_slots);
+
+		clear();
+
+		for (int i = 0; i < previousSlots.count(); ++i)
+		{
+			if (previousSlots.at(i).isValid)
+			{
+				addUrl(previousSlots.at(i).url, previousSlots.at(i).title, false);
+			}
+		}
+
+		optimize();
+	}
+}
+
+void HistoryIndex::setTitle(const QUrl &url, const QString &title)
+{
+	if (!m_urls.contains(url))
+	{
+		return;
+	}
+
+	const int slot(m_urls.value(url));
+	const QString normalizedTitle(title.toLower());
+
+	if (m_slots.at(slot).title != normalizedTitle)
+	{
+		m_slots[slot].title = normalizedTitle;
+
+		addTrigrams(slot, normalizedTitle);
+	}
+}
+
+void HistoryIndex::addTrigrams(int slot, const QString &text)
+{
+	QSet<quint64> trigrams;
+
+	for (int i = 0; i < (text.length() - 2); ++i)
+	{
+		trigrams.insert(getTrigram(text.constData() + i));
+	}
+
+	QSet<quint64>::const_iterator iterator;
+
+	for (iterator = trigrams.constBegin(); iterator != trigrams.constEnd(); ++iterator)
+	{
+		QVector<int> &trigramSlots(m_trigrams[*iterator]);
+
+		if (trigramSlots.isEmpty() || trigramSlots.last() != slot)
+		{
+			trigramSlots.append(slot);
+		}
+	}
+}
+
+void HistoryIndex::optimize()
+{
+	if (m_pendingEntries.isEmpty())
+	{
+		return;
+	}
+
+	const auto compare([&](const PrefixEntry &first, const PrefixEntry &second)
+	{
+		return (getKey(first).compare(getKey(second)) < 0);
+	});
+	const int amount(m_entries.count());
+
+	std::sort(m_pendingEntries.begin(), m_pendingEntries.end(), compare);
+
+	m_entries.append(m_pendingEntries);
+	m_pendingEntries.clear();
+
+	std::inplace_merge(m_entries.begin(), (m_entries.begin() + amount), m_entries.end(), compare);
+}
+
+QStringRef HistoryIndex::getKey(const PrefixEntry &entry) const
+{
+	return m_slots.at(entry.slot).text.midRef(entry.offset);
+}
+
+QVector<HistoryIndex::PrefixEntry>::const_iterator HistoryIndex::findEntry(const QString &key) const
+{
+	return std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), key, [&](const PrefixEntry &entry, const QString &value)
+	{
+		return (getKey(entry).compare(value) < 0);
+	});
+}
+
+QVector<QUrl> HistoryIndex::findPrefix(const QString &prefix, int limit) const
+{
+	QVector<QUrl> urls;
+
+	if (limit <= 0)
+	{
+		limit = m_urls.count();
+	}
+
+	if (prefix.isEmpty())
+	{
+		urls.reserve(qMin(limit, m_urls.count()));
+
+		for (int i = 0; (i < m_slots.count() && urls.count() < limit); ++i)
+		{
+			if (m_slots.at(i).isValid)
+			{
+				urls.append(m_slots.at(i).url);
+			}
+		}
+
+		return urls;
+	}
+
+	const QString normalizedPrefix(prefix.toLower());
+	const bool isSchemeFragment(QString(QLatin1String("http://")).startsWith(normalizedPrefix) || QString(QLatin1String("https://")).startsWith(normalizedPrefix));
+	QSet<int> matchedSlots;
+	QVector<PrefixEntry>::const_iterator iterator(findEntry(normalizedPrefix));
+
+	while (iterator != m_entries.constEnd() && urls.count() < limit)
+	{
+		const QStringRef key(getKey(*iterator));
+
+		if (!key.startsWith(normalizedPrefix))
+		{
+			break;
+		}
+
+		const int schemeLength(isSchemeFragment ? getSchemeLength(key) : 0);
+
+		if (schemeLength > normalizedPrefix.length())
+		{
+			QString nextKey(key.left(schemeLength).toString());
+			nextKey[schemeLength - 1] = QLatin1Char('0');
+
+			iterator = findEntry(nextKey);
+
+			continue;
+		}
+
+		if (m_slots.at(iterator->slot).isValid && !matchedSlots.contains(iterator->slot))
+		{
+			matchedSlots.insert(iterator->slot);
+			urls.append(m_slots.at(iterator->slot).url);
+		}
+
+		++iterator;
+	}
+
+	for (int i = 0; (i < m_pendingEntries.count() && urls.count() < limit); ++i)
+	{
+		const PrefixEntry &entry(m_pendingEntries.at(i));
+
+		if (isMatching(entry, normalizedPrefix) && !matchedSlots.contains(entry.slot) && (!isSchemeFragment || getSchemeLength(getKey(entry)) <= normalizedPrefix.length()))
+		{
+			matchedSlots.insert(entry.slot);
+			urls.append(m_slots.at(entry.slot).url);
+		}
+	}
+
+	return urls;
+}
+
+QVector<QUrl> HistoryIndex::findSubstring(const QString &text, int limit) const
+{
+	const QString normalizedText(text.toLower());
+
+	if (normalizedText.length() < 3)
+	{
+		return {};
+	}
+
+	const QVector<int> *candidates(nullptr);
+
+	for (int i = 0; i < (normalizedText.length() - 2); ++i)
+	{
+		const QHash<quint64, QVector<int> >::const_iterator iterator(m_trigrams.constFind(getTrigram(normalizedText.constData() + i)));
+
+		if (iterator == m_trigrams.constEnd())
+		{
+			return {};
+		}
+
+		if (!candidates || iterator->count() < candidates->count())
+		{
+			candidates = &iterator.value();
+		}
+	}
+
+	QVector<QUrl> urls;
+	QSet<int> matchedSlots;
+
+	for (int i = (candidates->count() - 1); (i >= 0 && urls.count() < limit); --i)
+	{
+		const int slot(candidates->at(i));
+		const Slot &slotData(m_slots.at(slot));
+
+		if (slotData.isValid && !matchedSlots.contains(slot) && (slotData.text.contains(normalizedText) || slotData.title.contains(normalizedText)))
+		{
+			matchedSlots.insert(slot);
+			urls.append(slotData.url);
+		}
+	}
+
+	return urls;
+}
+
+quint64 HistoryIndex::getTrigram(const QChar *characters)
+{
+	return ((static_cast<quint64>(characters[0].unicode()) << 32) | (static_cast<quint64>(characters[1].unicode()) << 16) | static_cast<quint64>(characters[2].unicode()));
+}
+
+int HistoryIndex::getSchemeLength(const QStringRef &key)
+{
+	if (key.startsWith(QLatin1String("http://")))
+	{
+		return 7;
+	}
+
+	if (key.startsWith(QLatin1String("https://")))
+	{
+		return 8;
+	}
+
+	return 0;
+}
+
+bool HistoryIndex::isMatching(const PrefixEntry &entry, const QString &prefix) const
+{
+	return (m_slots.at(entry.slot).isValid && getKey(entry).startsWith(prefix));
+}
+
+}
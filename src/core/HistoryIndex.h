@@ -0,0 +1,76 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYINDEX_H
+#define OTTER_HISTORYINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class HistoryIndex final
+{
+public:
+	explicit HistoryIndex();
+
+	void clear();
+	void addUrl(const QUrl &url, const QString &title, bool canOptimize = true);
+	void removeUrl(const QUrl &url);
+	void setTitle(const QUrl &url, const QString &title);
+	void optimize();
+	QVector<QUrl> findPrefix(const QString &prefix, int limit = 0) const;
+	QVector<QUrl> findSubstring(const QString &text, int limit) const;
+
+protected:
+	struct Slot final
+	{
+		QUrl url;
+		QString text;
+		QString title;
+		bool isValid = false;
+	};
+
+	struct PrefixEntry final
+	{
+		int slot = 0;
+		int offset = 0;
+	};
+
+	void addTrigrams(int slot, const QString &text);
+	QStringRef getKey(const PrefixEntry &entry) const;
+	QVector<PrefixEntry>::const_iterator findEntry(const QString &key) const;
+	static int getSchemeLength(const QStringRef &key);
+	static quint64 getTrigram(const QChar *characters);
+	bool isMatching(const PrefixEntry &entry, const QString &prefix) const;
+
+private:
+	QVector<Slot> m_slots;
+	QVector<PrefixEntry> m_entries;
+	QVector<PrefixEntry> m_pendingEntries;
+	QHash<QUrl, int> m_urls;
+	QHash<quint64, QVector<int> > m_trigrams;
+	int m_invalidSlotsAmount;
+};
+
+}
+
+#endif
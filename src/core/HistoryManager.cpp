@@ -21,6 +21,8 @@
 #include "HistoryManager.h"
 #include "AddonsManager.h"
 #include "Application.h"
+#include "BookmarksManager.h"
+#include "FaviconsStore.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "ThemesManager.h"
@@ -31,12 +33,14 @@ namespace Otter
 {
 
 HistoryManager* HistoryManager::m_instance(nullptr);
+FaviconsStore* HistoryManager::m_faviconsStore(nullptr);
 HistoryModel* HistoryManager::m_browsingHistoryModel(nullptr);
 HistoryModel* HistoryManager::m_typedHistoryModel(nullptr);
 bool HistoryManager::m_isEnabled(false);
 bool HistoryManager::m_isStoringFavicons(true);
 
 HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
+	m_retentionTimer(0),
 	m_saveTimer(0)
 {
 	m_dayTimer = startTimer(QTime::currentTime().msecsTo(QTime(23, 59, 59, 999)));
@@ -47,6 +51,18 @@ HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &HistoryManager::handleOptionChanged);
 }
 
+HistoryManager::~HistoryManager()
+{
+	if (m_faviconsStore)
+	{
+		m_faviconsStore->flush();
+
+		delete m_faviconsStore;
+
+		m_faviconsStore = nullptr;
+	}
+}
+
 void HistoryManager::createInstance()
 {
 	if (!m_instance)
@@ -65,31 +81,56 @@ void HistoryManager::timerEvent(QTimerEvent *event)
 
 		save();
 	}
+	else if (event->timerId() == m_retentionTimer)
+	{
+		killTimer(m_retentionTimer);
+
+		m_retentionTimer = 0;
+
+		applyRetention();
+	}
 	else if (event->timerId() == m_dayTimer)
 	{
 		killTimer(m_dayTimer);
 
-		if (!m_browsingHistoryModel)
-		{
-			getBrowsingHistoryModel();
-		}
+		applyRetention();
 
-		if (!m_typedHistoryModel)
-		{
-			getTypedHistoryModel();
-		}
-
-		const int period(SettingsManager::getOption(SettingsManager::History_BrowsingLimitPeriodOption).toInt());
+		emit dayChanged();
 
-		m_browsingHistoryModel->clearOldestEntries(period);
-		m_typedHistoryModel->clearOldestEntries(period);
+		m_dayTimer = startTimer(QTime::currentTime().msecsTo(QTime(23, 59, 59, 999)));
+	}
+}
 
-		scheduleSave();
+void HistoryManager::scheduleRetention()
+{
+	if (m_retentionTimer == 0 && !Application::isAboutToQuit())
+	{
+		m_retentionTimer = startTimer(5000);
+	}
+}
 
-		emit dayChanged();
+void HistoryManager::applyRetention()
+{
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
 
-		m_dayTimer = startTimer(QTime::currentTime().msecsTo(QTime(23, 59, 59, 999)));
+	if (!m_typedHistoryModel)
+	{
+		getTypedHistoryModel();
 	}
+
+	const int limit(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
+	const int period(SettingsManager::getOption(SettingsManager::History_BrowsingLimitPeriodOption).toInt());
+
+	m_browsingHistoryModel->clearOldestEntries(period);
+	m_browsingHistoryModel->clearExcessEntries(limit);
+	m_browsingHistoryModel->downsampleEntries(SettingsManager::getOption(SettingsManager::History_BrowsingDownsamplePeriodOption).toInt());
+	m_typedHistoryModel->clearOldestEntries(period);
+	m_typedHistoryModel->clearExcessEntries(limit);
+
+	scheduleSave();
 }
 
 void HistoryManager::scheduleSave()
@@ -115,12 +156,17 @@ void HistoryManager::save()
 {
 	if (m_browsingHistoryModel)
 	{
-		m_browsingHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")));
+		m_browsingHistoryModel->save();
 	}
 
 	if (m_typedHistoryModel)
 	{
-		m_typedHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")));
+		m_typedHistoryModel->save();
+	}
+
+	if (m_faviconsStore)
+	{
+		m_faviconsStore->flush();
 	}
 }
 
@@ -138,6 +184,13 @@ void HistoryManager::clearHistory(uint period)
 
 	m_browsingHistoryModel->clearRecentEntries(period);
 	m_typedHistoryModel->clearRecentEntries(period);
+
+	if (period == 0)
+	{
+		getFaviconsStore()->clear();
+
+		m_instance->scheduleSave();
+	}
 }
 
 void HistoryManager::removeEntry(quint64 identifier)
@@ -167,10 +220,7 @@ void HistoryManager::removeEntries(const QVector<quint64> &identifiers)
 		getBrowsingHistoryModel();
 	}
 
-	for (int i = 0; i < identifiers.count(); ++i)
-	{
-		m_browsingHistoryModel->removeEntry(identifiers.at(i));
-	}
+	m_browsingHistoryModel->removeEntries(identifiers);
 }
 
 void HistoryManager::updateEntry(quint64 identifier, const QUrl &url, const QString &title, const QIcon &icon)
@@ -202,6 +252,28 @@ void HistoryManager::updateEntry(quint64 identifier, const QUrl &url, const QStr
 
 		m_instance->scheduleSave();
 	}
+
+	if (m_isStoringFavicons && !icon.isNull())
+	{
+		getFaviconsStore()->setIcon(url, icon);
+
+		m_instance->scheduleSave();
+	}
+}
+
+void HistoryManager::setIcon(const QUrl &url, const QIcon &icon)
+{
+	if (!m_isEnabled || !m_isStoringFavicons || icon.isNull())
+	{
+		return;
+	}
+
+	getFaviconsStore()->setIcon(url, icon, false);
+
+	if (m_instance)
+	{
+		m_instance->scheduleSave();
+	}
 }
 
 void HistoryManager::handleOptionChanged(int identifier)
@@ -213,34 +285,10 @@ void HistoryManager::handleOptionChanged(int identifier)
 			m_isEnabled = (SettingsManager::getOption(SettingsManager::History_RememberBrowsingOption).toBool() && !SettingsManager::getOption(SettingsManager::Browser_PrivateModeOption).toBool());
 
 			break;
+		case SettingsManager::History_BrowsingDownsamplePeriodOption:
 		case SettingsManager::History_BrowsingLimitAmountGlobalOption:
 		case SettingsManager::History_BrowsingLimitPeriodOption:
-			if (!m_browsingHistoryModel)
-			{
-				getBrowsingHistoryModel();
-			}
-
-			if (!m_typedHistoryModel)
-			{
-				getTypedHistoryModel();
-			}
-
-			if (identifier == SettingsManager::History_BrowsingLimitAmountGlobalOption)
-			{
-				const int limit(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
-
-				m_browsingHistoryModel->clearExcessEntries(limit);
-				m_typedHistoryModel->clearExcessEntries(limit);
-			}
-			else
-			{
-				const int period(SettingsManager::getOption(SettingsManager::History_BrowsingLimitPeriodOption).toInt());
-
-				m_browsingHistoryModel->clearOldestEntries(period);
-				m_typedHistoryModel->clearOldestEntries(period);
-			}
-
-			scheduleSave();
+			scheduleRetention();
 
 			break;
 		case SettingsManager::History_StoreFaviconsOption:
@@ -261,9 +309,13 @@ HistoryModel* HistoryManager::getBrowsingHistoryModel()
 {
 	if (!m_browsingHistoryModel)
 	{
-		m_browsingHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")), HistoryModel::BrowsingHistory, m_instance);
+		m_browsingHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat")), HistoryModel::BrowsingHistory, m_instance);
 
 		connect(m_browsingHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
+		connect(m_browsingHistoryModel, &HistoryModel::urlsRemoved, m_instance, [](const QVector<QUrl> &urls, const QStringList &hosts)
+		{
+			getFaviconsStore()->removeIcons(urls, hosts);
+		});
 	}
 
 	return m_browsingHistoryModel;
@@ -273,7 +325,7 @@ HistoryModel* HistoryManager::getTypedHistoryModel()
 {
 	if (!m_typedHistoryModel && m_instance)
 	{
-		m_typedHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")), HistoryModel::TypedHistory, m_instance);
+		m_typedHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.dat")), HistoryModel::TypedHistory, m_instance);
 
 		connect(m_typedHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
 	}
@@ -291,11 +343,27 @@ QDateTime HistoryManager::getLastVisitTime(const QUrl &url)
 	return m_browsingHistoryModel->getLastVisitTime(url);
 }
 
+FaviconsStore* HistoryManager::getFaviconsStore()
+{
+	if (!m_faviconsStore)
+	{
+		m_faviconsStore = new FaviconsStore(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")));
+	}
+
+	return m_faviconsStore;
+}
+
 QIcon HistoryManager::getIcon(const QString &host)
 {
-	Q_UNUSED(host)
+	if (m_isStoringFavicons && !host.isEmpty())
+	{
+		const QIcon icon(getFaviconsStore()->getIcon(host));
 
-///TODO
+		if (!icon.isNull())
+		{
+			return icon;
+		}
+	}
 
 	return ThemesManager::createIcon(QLatin1String("text-html"));
 }
@@ -322,11 +390,29 @@ QIcon HistoryManager::getIcon(const QUrl &url)
 		}
 	}
 
-///TODO
+	if (m_isStoringFavicons)
+	{
+		const QIcon icon(getFaviconsStore()->getIcon(url));
+
+		if (!icon.isNull())
+		{
+			return icon;
+		}
+	}
 
 	return ThemesManager::createIcon(QLatin1String("text-html"));
 }
 
+QIcon HistoryManager::getStoredIcon(const QUrl &url)
+{
+	if (!m_isStoringFavicons || !url.isValid())
+	{
+		return {};
+	}
+
+	return getFaviconsStore()->getIcon(url, true);
+}
+
 HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
 {
 	if (!m_browsingHistoryModel)
@@ -337,23 +423,78 @@ HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
 	return m_browsingHistoryModel->getEntry(identifier);
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly)
+QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly, int limit)
 {
 	if (!m_typedHistoryModel)
 	{
 		getTypedHistoryModel();
 	}
 
-	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true));
+	if (isTypedInOnly)
+	{
+		return m_typedHistoryModel->findEntries(prefix, true, limit);
+	}
+
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
+
+	const auto getWeight([](const QUrl &url) -> double
+	{
+		const BookmarksModel::Bookmark *bookmark(BookmarksManager::getBookmark(url));
+
+		if (!bookmark)
+		{
+			return 1;
+		}
+
+		return (bookmark->getKeyword().isEmpty() ? 2 : 3);
+	});
+	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true, limit, getWeight));
+	const QVector<HistoryModel::HistoryEntryMatch> browsingEntries(m_browsingHistoryModel->findEntries(prefix, false, limit, getWeight));
+	QHash<QUrl, int> indexes;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		entries[i].score *= 2;
+
+		indexes[entries.at(i).url] = i;
+	}
+
+	for (int i = 0; i < browsingEntries.count(); ++i)
+	{
+		const HistoryModel::HistoryEntryMatch &entry(browsingEntries.at(i));
+
+		if (indexes.contains(entry.url))
+		{
+			HistoryModel::HistoryEntryMatch &typedEntry(entries[indexes[entry.url]]);
+			typedEntry.score += entry.score;
 
-	if (!isTypedInOnly)
+			if (typedEntry.match.isEmpty())
+			{
+				typedEntry.match = entry.match;
+			}
+		}
+		else
+		{
+			entries.append(entry);
+		}
+	}
+
+	std::stable_sort(entries.begin(), entries.end(), [&](const HistoryModel::HistoryEntryMatch &first, const HistoryModel::HistoryEntryMatch &second)
 	{
-		if (!m_browsingHistoryModel)
+		if (first.match.isEmpty() != second.match.isEmpty())
 		{
-			getBrowsingHistoryModel();
+			return second.match.isEmpty();
 		}
 
-		entries.append(m_browsingHistoryModel->findEntries(prefix));
+		return (first.score > second.score);
+	});
+
+	if (limit > 0 && entries.count() > limit)
+	{
+		entries.resize(limit);
 	}
 
 	return entries;
@@ -383,14 +524,16 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 		m_typedHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc());
 	}
 
+	if (m_isStoringFavicons && !icon.isNull())
+	{
+		getFaviconsStore()->setIcon(url, icon);
+	}
+
 	const int limit(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
 
-	if (limit > 0 && m_browsingHistoryModel->rowCount() > limit)
+	if (limit > 0 && m_browsingHistoryModel->getEntriesAmount() > limit)
 	{
-		for (int i = (m_browsingHistoryModel->rowCount() - 1); i >= limit; --i)
-		{
-			m_browsingHistoryModel->removeEntry(m_browsingHistoryModel->index(i, 0).data(HistoryModel::IdentifierRole).toULongLong());
-		}
+		m_instance->scheduleRetention();
 	}
 
 	return identifier;
@@ -411,4 +554,19 @@ bool HistoryManager::hasEntry(const QUrl &url)
 	return m_browsingHistoryModel->hasEntry(url);
 }
 
+bool HistoryManager::isVisited(const QString &url)
+{
+	if (!m_isEnabled)
+	{
+		return false;
+	}
+
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
+
+	return (m_browsingHistoryModel->mayHaveEntry(url) && m_browsingHistoryModel->hasEntry(QUrl(url)));
+}
+
 }
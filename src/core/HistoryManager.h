@@ -29,6 +29,8 @@
 namespace Otter
 {
 
+class FaviconsStore;
+
 class HistoryManager final : public QObject
 {
 	Q_OBJECT
@@ -39,32 +41,41 @@ public:
 	static void removeEntry(quint64 identifier);
 	static void removeEntries(const QVector<quint64> &identifiers);
 	static void updateEntry(quint64 identifier, const QUrl &url, const QString &title = {}, const QIcon &icon = {});
+	static void setIcon(const QUrl &url, const QIcon &icon);
 	static HistoryManager* getInstance();
 	static HistoryModel* getBrowsingHistoryModel();
 	static HistoryModel* getTypedHistoryModel();
 	static QDateTime getLastVisitTime(const QUrl &url);
 	static QIcon getIcon(const QString &host);
 	static QIcon getIcon(const QUrl &url);
+	static QIcon getStoredIcon(const QUrl &url);
 	static HistoryModel::Entry* getEntry(quint64 identifier);
-	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false);
+	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false, int limit = 0);
 	static quint64 addEntry(const QUrl &url, const QString &title = {}, const QIcon &icon = {}, bool isTypedIn = false);
 	static bool hasEntry(const QUrl &url);
+	static bool isVisited(const QString &url);
 
 protected:
 	explicit HistoryManager(QObject *parent);
+	~HistoryManager();
 
 	void timerEvent(QTimerEvent *event) override;
+	void scheduleRetention();
 	void scheduleSave();
+	void applyRetention();
 	void save();
+	static FaviconsStore* getFaviconsStore();
 
 protected slots:
 	void handleOptionChanged(int identifier);
 
 private:
 	int m_dayTimer;
+	int m_retentionTimer;
 	int m_saveTimer;
 
 	static HistoryManager *m_instance;
+	static FaviconsStore *m_faviconsStore;
 	static HistoryModel *m_browsingHistoryModel;
 	static HistoryModel *m_typedHistoryModel;
 	static bool m_isEnabled;
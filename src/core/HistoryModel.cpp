@@ -19,15 +19,17 @@
 **************************************************************************/
 
 #include "HistoryModel.h"
-#include "Console.h"
-#include "JsonSettings.h"
-#include "SessionsManager.h"
-#include "ThemesManager.h"
+#include "HistoryManager.h"
 #include "Utils.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
-#include <QtCore/QJsonArray>
-#include <QtCore/QJsonObject>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
+
+#include <algorithm>
+#include <limits>
 
 namespace Otter
 {
@@ -70,7 +72,7 @@ QIcon HistoryModel::Entry::getIcon() const
 {
 	const QVariant iconData(data(Qt::DecorationRole));
 
-	return (iconData.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : iconData.value<QIcon>());
+	return (iconData.isNull() ? HistoryManager::getIcon(getUrl()) : iconData.value<QIcon>());
 }
 
 quint64 HistoryModel::Entry::getIdentifier() const
@@ -84,42 +86,34 @@ bool HistoryModel::Entry::isValid() const
 }
 
 HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QStandardItemModel(parent),
+	m_store(new HistoryStore(path)),
 	m_type(type)
 {
-	QFile file(path);
-
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	if (!QFile::exists(path))
 	{
-		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
-
-		return;
-	}
-
-	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+		const QFileInfo information(path);
+		const QString legacyPath(information.absoluteDir().filePath(information.completeBaseName() + QLatin1String(".json")));
 
-	file.close();
-
-	for (int i = 0; i < historyArray.count(); ++i)
-	{
-		const QJsonObject entryObject(historyArray.at(i).toObject());
-		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
-		dateTime.setTimeSpec(Qt::UTC);
-
-		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
+		if (QFile::exists(legacyPath) && m_store->importJson(legacyPath))
+		{
+			m_store->flush();
+		}
 	}
 
 	setSortRole(TimeVisitedRole);
-	sort(0, Qt::DescendingOrder);
+	fetchMore({});
+}
+
+HistoryModel::~HistoryModel()
+{
+	delete m_store;
 }
 
 void HistoryModel::clearExcessEntries(int limit)
 {
-	if (limit > 0 && rowCount() > limit)
+	if (limit > 0 && m_store->getVisitsAmount() > limit)
 	{
-		for (int i = (rowCount() - 1); i >= limit; --i)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		removeEntries(m_store->getOldestVisits(m_store->getVisitsAmount() - limit));
 	}
 }
 
@@ -129,21 +123,16 @@ void HistoryModel::clearRecentEntries(uint period)
 	{
 		clear();
 
-		m_urls.clear();
+		m_store->clear();
 		m_identifiers.clear();
 
 		emit cleared();
+		emit modelModified();
 
 		return;
 	}
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
-	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
-	}
+	removeEntries(m_store->getVisitsRange(QDateTime::currentDateTimeUtc().addSecs(-static_cast<qint64>(period) * 3600).toMSecsSinceEpoch(), std::numeric_limits<qint64>::max()));
 }
 
 void HistoryModel::clearOldestEntries(int period)
@@ -153,48 +142,150 @@ void HistoryModel::clearOldestEntries(int period)
 		return;
 	}
 
-	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	removeEntries(m_store->getVisitsRange(std::numeric_limits<qint64>::min(), QDateTime(QDateTime::currentDateTimeUtc().date().addDays(-period), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch()));
+}
+
+void HistoryModel::downsampleEntries(int period)
+{
+	if (period <= 0)
+	{
+		return;
+	}
+
+	const QVector<quint64> identifiers(m_store->downsampleVisits(QDateTime(QDateTime::currentDateTimeUtc().date().addDays(-period), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch()));
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
+	if (!identifiers.isEmpty())
 	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().daysTo(currentDateTime) > period)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		removeMaterializedEntries(identifiers);
+
+		emit entriesRemoved(identifiers);
+		emit modelModified();
 	}
 }
 
 void HistoryModel::removeEntry(quint64 identifier)
 {
-	Entry *entry(getEntry(identifier));
+	if (!m_store->hasVisit(identifier))
+	{
+		return;
+	}
 
-	if (!entry)
+	m_store->removeVisit(identifier);
+
+	Entry *entry(m_identifiers.take(identifier));
+
+	if (entry)
+	{
+		emit entryRemoved(entry);
+
+		removeRow(entry->row());
+	}
+
+	notifyUrlsRemoved();
+
+	emit entriesRemoved({identifier});
+	emit modelModified();
+}
+
+void HistoryModel::removeEntries(const QVector<quint64> &identifiers)
+{
+	if (identifiers.isEmpty())
 	{
 		return;
 	}
 
-	const QUrl url(Utils::normalizeUrl(entry->getUrl()));
+	m_store->removeVisits(identifiers);
+
+	removeMaterializedEntries(identifiers);
+	notifyUrlsRemoved();
+
+	emit entriesRemoved(identifiers);
+	emit modelModified();
+}
 
-	if (m_urls.contains(url))
+void HistoryModel::removeMaterializedEntries(const QVector<quint64> &identifiers)
+{
+	QVector<int> rows;
+	rows.reserve(identifiers.count());
+
+	for (int i = 0; i < identifiers.count(); ++i)
 	{
-		m_urls[url].removeAll(entry);
+		Entry *entry(m_identifiers.take(identifiers.at(i)));
 
-		if (m_urls[url].isEmpty())
+		if (entry)
 		{
-			m_urls.remove(url);
+			emit entryRemoved(entry);
+
+			rows.append(entry->row());
 		}
 	}
 
-	if (identifier > 0 && m_identifiers.contains(identifier))
+	std::sort(rows.begin(), rows.end());
+
+	for (int i = (rows.count() - 1); i >= 0;)
 	{
-		m_identifiers.remove(identifier);
+		int first(i);
+
+		while (first > 0 && rows.at(first - 1) == (rows.at(first) - 1))
+		{
+			--first;
+		}
+
+		removeRows(rows.at(first), (i - first + 1));
+
+		i = (first - 1);
 	}
+}
 
-	emit entryRemoved(entry);
+void HistoryModel::notifyUrlsRemoved()
+{
+	const QVector<QUrl> urls(m_store->takeRemovedUrls());
+	const QStringList hosts(m_store->takeRemovedHosts());
 
-	removeRow(entry->row());
+	if (!urls.isEmpty() || !hosts.isEmpty())
+	{
+		emit urlsRemoved(urls, hosts);
+	}
+}
 
-	emit modelModified();
+void HistoryModel::fetchMore(const QModelIndex &parent)
+{
+	if (parent.isValid())
+	{
+		return;
+	}
+
+	qint64 timeVisited(std::numeric_limits<qint64>::max());
+	quint64 identifier(std::numeric_limits<quint64>::max());
+
+	if (rowCount() > 0)
+	{
+		const Entry *entry(static_cast<Entry*>(item((rowCount() - 1), 0)));
+
+		timeVisited = entry->getTimeVisited().toMSecsSinceEpoch();
+		identifier = entry->getIdentifier();
+	}
+
+	const QVector<HistoryStore::Visit> visits(m_store->getVisits(timeVisited, identifier, 500));
+
+	if (visits.isEmpty())
+	{
+		return;
+	}
+
+	QList<QStandardItem*> entries;
+	entries.reserve(visits.count());
+
+	for (int i = 0; i < visits.count(); ++i)
+	{
+		Entry *entry(createEntry(visits.at(i)));
+
+		m_identifiers[visits.at(i).identifier] = entry;
+
+		entries.append(entry);
+	}
+
+	invisibleRootItem()->appendRows(entries);
 }
 
 HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date, quint64 identifier)
@@ -203,32 +294,20 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 
 	if (m_type == TypedHistory && hasEntry(url))
 	{
-		const QVector<Entry*> entries(m_urls[Utils::normalizeUrl(url)]);
+		const QVector<quint64> identifiers(m_store->getUrlVisits(url));
 
-		for (int i = 0; i < entries.count(); ++i)
+		for (int i = 0; i < identifiers.count(); ++i)
 		{
-			removeEntry(entries.at(i)->getIdentifier());
+			removeEntry(identifiers.at(i));
 		}
 	}
 
-	Entry *entry(new Entry());
+	Entry *entry(createEntry(m_store->getVisit(m_store->addVisit(url, title, date.toMSecsSinceEpoch(), identifier))));
 	entry->setIcon(icon);
 
-	const QModelIndex index(entry->index());
-
 	insertRow(0, entry);
-	setData(index, url, UrlRole);
-	setData(index, title, TitleRole);
-	setData(index, date, TimeVisitedRole);
 
-	if (identifier == 0 || m_identifiers.contains(identifier))
-	{
-		identifier = (m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
-	}
-
-	setData(index, identifier, IdentifierRole);
-
-	m_identifiers[identifier] = entry;
+	m_identifiers[entry->getIdentifier()] = entry;
 
 	blockSignals(false);
 
@@ -238,117 +317,155 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 	return entry;
 }
 
-HistoryModel::Entry* HistoryModel::getEntry(quint64 identifier) const
+HistoryModel::Entry* HistoryModel::createEntry(const HistoryStore::Visit &visit) const
 {
-	if (m_identifiers.contains(identifier))
+	Entry *entry(new Entry());
+	entry->setItemData(m_store->getUrlEntry(visit.url).url, UrlRole);
+	entry->setItemData(visit.title, TitleRole);
+	entry->setItemData(QDateTime::fromMSecsSinceEpoch(visit.timeVisited, Qt::UTC), TimeVisitedRole);
+	entry->setItemData(visit.identifier, IdentifierRole);
+
+	return entry;
+}
+
+HistoryModel::Entry* HistoryModel::getEntry(quint64 identifier)
+{
+	if (!m_identifiers.contains(identifier) && m_store->hasVisit(identifier))
 	{
-		return m_identifiers[identifier];
+		while (!m_identifiers.contains(identifier) && canFetchMore({}))
+		{
+			fetchMore({});
+		}
 	}
 
-	return nullptr;
+	return m_identifiers.value(identifier, nullptr);
 }
 
 QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const HistoryStore::Visit visit(m_store->getLastVisit(url));
 
-	if (!m_urls.contains(normalizedUrl))
+	if (!visit.isValid())
 	{
 		return {};
 	}
 
-	const QVector<Entry*> entries(m_urls.value(normalizedUrl));
-	QDateTime lastVisitTime;
+	return QDateTime::fromMSecsSinceEpoch(visit.timeVisited, Qt::UTC);
+}
 
-	for (int i = 0; i < entries.count(); ++i)
-	{
-		const QDateTime entryLastVisitTime(entries.at(i)->getTimeVisited());
+HistoryStore::Visit HistoryModel::getVisit(quint64 identifier) const
+{
+	return m_store->getVisit(identifier);
+}
 
-		if (!lastVisitTime.isValid() || entryLastVisitTime > lastVisitTime)
-		{
-			lastVisitTime = entryLastVisitTime;
-		}
-	}
+QUrl HistoryModel::getVisitUrl(const HistoryStore::Visit &visit) const
+{
+	return m_store->getUrlEntry(visit.url).url;
+}
+
+QVector<HistoryStore::Visit> HistoryModel::getVisits(qint64 timeVisited, quint64 identifier, int amount) const
+{
+	return m_store->getVisits(timeVisited, identifier, amount);
+}
+
+QVector<HistoryStore::Visit> HistoryModel::findMatchingVisits(const QString &text) const
+{
+	return m_store->findMatchingVisits(text);
+}
 
-	return lastVisitTime;
+QVector<quint64> HistoryModel::getHostEntries(const QString &host) const
+{
+	return m_store->getHostVisits(host);
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
+QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn, int limit, const std::function<double(const QUrl &url)> &getWeight) const
 {
-	QVector<Entry*> matchedEntries;
+	const QVector<HistoryStore::Visit> visits(m_store->findVisits(prefix, limit, getWeight));
+	const qint64 time(QDateTime::currentMSecsSinceEpoch());
 	QVector<HistoryEntryMatch> allMatches;
-	QVector<HistoryEntryMatch> currentMatches;
-	QMultiMap<QDateTime, HistoryEntryMatch> matchesMap;
-	QHash<QUrl, QVector<Entry*> >::const_iterator urlsIterator;
+	QSet<quint64> matchedVisits;
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	if (limit <= 0)
 	{
-		if (urlsIterator.value().isEmpty() || matchedEntries.contains(urlsIterator.value().value(0)))
-		{
-			continue;
-		}
+		limit = std::numeric_limits<int>::max();
+	}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+	allMatches.reserve(visits.count());
+
+	for (int i = 0; (i < visits.count() && allMatches.count() < limit); ++i)
+	{
+		const QString result(Utils::matchUrl(m_store->getUrlEntry(visits.at(i).url).normalizedUrl, prefix));
 
 		if (!result.isEmpty())
 		{
-			HistoryEntryMatch match;
-			match.entry = urlsIterator.value().value(0);
-			match.match = result;
+			allMatches.append(createMatch(visits.at(i), result, time, markAsTypedIn, getWeight));
 
-			if (markAsTypedIn)
-			{
-				match.isTypedIn = true;
-			}
-
-			matchesMap.insert(match.entry->data(TimeVisitedRole).toDateTime(), match);
-
-			matchedEntries.append(match.entry);
+			matchedVisits.insert(visits.at(i).identifier);
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
+	if (prefix.length() < 3 || allMatches.count() >= limit)
+	{
+		return allMatches;
+	}
 
-	matchesMap.clear();
+	const QVector<HistoryStore::Visit> substringVisits(m_store->findVisitsContaining(prefix, 20));
+	QMultiMap<qint64, HistoryStore::Visit> visitsMap;
+
+	for (int i = 0; i < substringVisits.count(); ++i)
+	{
+		if (!matchedVisits.contains(substringVisits.at(i).identifier))
+		{
+			visitsMap.insert(substringVisits.at(i).timeVisited, substringVisits.at(i));
+		}
+	}
 
-	allMatches.reserve(currentMatches.count());
+	QMultiMap<qint64, HistoryStore::Visit>::const_iterator iterator(visitsMap.constEnd());
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	while (iterator != visitsMap.constBegin() && allMatches.count() < limit)
 	{
-		allMatches.append(currentMatches.at(i));
+		--iterator;
+
+		allMatches.append(createMatch(iterator.value(), {}, time, markAsTypedIn, getWeight));
 	}
 
 	return allMatches;
 }
 
+HistoryModel::HistoryEntryMatch HistoryModel::createMatch(const HistoryStore::Visit &visit, const QString &match, qint64 time, bool isTypedIn, const std::function<double(const QUrl &url)> &getWeight) const
+{
+	const Entry *entry(m_identifiers.value(visit.identifier, nullptr));
+	HistoryEntryMatch entryMatch;
+	entryMatch.match = match;
+	entryMatch.title = (entry ? entry->getTitle() : (visit.title.isNull() ? QCoreApplication::translate("Otter::HistoryEntryItem", "(Untitled)") : visit.title));
+	entryMatch.url = m_store->getUrlEntry(visit.url).url;
+	entryMatch.icon = (entry ? entry->getIcon() : HistoryManager::getIcon(entryMatch.url));
+	entryMatch.timeVisited = QDateTime::fromMSecsSinceEpoch(visit.timeVisited, Qt::UTC);
+	entryMatch.identifier = visit.identifier;
+	entryMatch.score = (m_store->getFrecency(visit.url, time) * (getWeight ? getWeight(entryMatch.url) : 1));
+	entryMatch.isTypedIn = isTypedIn;
+
+	return entryMatch;
+}
+
 HistoryModel::HistoryType HistoryModel::getType() const
 {
 	return m_type;
 }
 
-bool HistoryModel::save(const QString &path) const
+int HistoryModel::getEntriesAmount() const
 {
-	if (SessionsManager::isReadOnly())
-	{
-		return false;
-	}
-
-	QJsonArray historyArray;
-
-	for (int i = 0; i < rowCount(); ++i)
-	{
-		const QModelIndex index(this->index(i, 0));
-
-		if (index.isValid())
-		{
-			historyArray.prepend({{{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}});
-		}
-	}
+	return m_store->getVisitsAmount();
+}
 
-	JsonSettings settings;
-	settings.setArray(historyArray);
+bool HistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+	return (!parent.isValid() && m_store->getVisitsAmount() > rowCount());
+}
 
-	return settings.save(path);
+bool HistoryModel::save()
+{
+	return m_store->flush();
 }
 
 bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -360,38 +477,23 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 		return QStandardItemModel::setData(index, value, role);
 	}
 
-	if (role == UrlRole && value.toUrl() != index.data(UrlRole).toUrl())
-	{
-		const QUrl oldUrl(Utils::normalizeUrl(index.data(UrlRole).toUrl()));
-		const QUrl newUrl(Utils::normalizeUrl(value.toUrl()));
-
-		if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
-		{
-			m_urls[oldUrl].removeAll(entry);
-
-			if (m_urls[oldUrl].isEmpty())
-			{
-				m_urls.remove(oldUrl);
-			}
-		}
-
-		if (!newUrl.isEmpty())
-		{
-			if (!m_urls.contains(newUrl))
-			{
-				m_urls[newUrl] = {};
-			}
-
-			m_urls[newUrl].append(entry);
-		}
-	}
-
 	entry->setItemData(value, role);
 
 	switch (role)
 	{
 		case TitleRole:
 		case UrlRole:
+			if (entry->isValid())
+			{
+				m_store->updateVisit(entry->getIdentifier(), entry->getUrl(), entry->data(TitleRole).toString());
+
+				notifyUrlsRemoved();
+			}
+
+			emit entryModified(entry);
+			emit modelModified();
+
+			break;
 		case IdentifierRole:
 		case TimeVisitedRole:
 			emit entryModified(entry);
@@ -407,7 +509,12 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 
 bool HistoryModel::hasEntry(const QUrl &url) const
 {
-	return m_urls.contains(Utils::normalizeUrl(url));
+	return m_store->hasUrl(url);
+}
+
+bool HistoryModel::mayHaveEntry(const QString &url) const
+{
+	return m_store->mayHaveUrl(url);
 }
 
 }
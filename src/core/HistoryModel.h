@@ -21,6 +21,8 @@
 #ifndef OTTER_HISTORYMODEL_H
 #define OTTER_HISTORYMODEL_H
 
+#include "HistoryStore.h"
+
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtGui/QStandardItemModel>
@@ -67,29 +69,52 @@ public:
 
 	struct HistoryEntryMatch final
 	{
-		Entry *entry = nullptr;
 		QString match;
+		QString title;
+		QUrl url;
+		QIcon icon;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		double score = 0;
 		bool isTypedIn = false;
 	};
 
 	explicit HistoryModel(const QString &path, HistoryType type, QObject *parent = nullptr);
+	~HistoryModel();
 
 	void clearExcessEntries(int limit);
 	void clearRecentEntries(uint period);
 	void clearOldestEntries(int period);
+	void downsampleEntries(int period);
 	void removeEntry(quint64 identifier);
+	void removeEntries(const QVector<quint64> &identifiers);
+	void fetchMore(const QModelIndex &parent) override;
 	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
-	Entry* getEntry(quint64 identifier) const;
+	Entry* getEntry(quint64 identifier);
 	QDateTime getLastVisitTime(const QUrl &url) const;
-	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	HistoryStore::Visit getVisit(quint64 identifier) const;
+	QUrl getVisitUrl(const HistoryStore::Visit &visit) const;
+	QVector<HistoryStore::Visit> getVisits(qint64 timeVisited, quint64 identifier, int amount) const;
+	QVector<HistoryStore::Visit> findMatchingVisits(const QString &text) const;
+	QVector<quint64> getHostEntries(const QString &host) const;
+	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false, int limit = 0, const std::function<double(const QUrl &url)> &getWeight = nullptr) const;
 	HistoryType getType() const;
+	int getEntriesAmount() const;
+	bool canFetchMore(const QModelIndex &parent) const override;
 	bool hasEntry(const QUrl &url) const;
-	bool save(const QString &path) const;
+	bool mayHaveEntry(const QString &url) const;
+	bool save();
 	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
+protected:
+	void removeMaterializedEntries(const QVector<quint64> &identifiers);
+	void notifyUrlsRemoved();
+	Entry* createEntry(const HistoryStore::Visit &visit) const;
+	HistoryEntryMatch createMatch(const HistoryStore::Visit &visit, const QString &match, qint64 time, bool isTypedIn, const std::function<double(const QUrl &url)> &getWeight) const;
+
 private:
-	QHash<QUrl, QVector<Entry*> > m_urls;
-	QMap<quint64, Entry*> m_identifiers;
+	HistoryStore *m_store;
+	QHash<quint64, Entry*> m_identifiers;
 	HistoryType m_type;
 
 signals:
@@ -97,6 +122,8 @@ signals:
 	void entryAdded(Entry *entry);
 	void entryModified(Entry *entry);
 	void entryRemoved(Entry *entry);
+	void entriesRemoved(const QVector<quint64> &identifiers);
+	void urlsRemoved(const QVector<QUrl> &urls, const QStringList &hosts);
 	void modelModified();
 };
 
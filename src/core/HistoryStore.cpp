@@ -0,0 +1,1161 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryStore.h"
+#include "Console.h"
+#include "SessionsManager.h"
+#include "Utils.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Otter
+{
+
+const quint32 HistoryStore::LogMagic(0x4F48534C);
+const quint32 HistoryStore::LogVersion(2);
+
+HistoryStore::HistoryStore(const QString &path) :
+	m_path(path),
+	m_nextVisitIdentifier(1),
+	m_nextUrlIdentifier(1),
+	m_nextHostIdentifier(1),
+	m_obsoleteRecordsAmount(0),
+	m_isIndexEnabled(false),
+	m_needsCompaction(false)
+{
+	load();
+	rebuildIndex();
+
+	m_removedUrls.clear();
+	m_removedHosts.clear();
+}
+
+void HistoryStore::load()
+{
+	QFile file(m_path);
+
+	if (!file.exists())
+	{
+		return;
+	}
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	quint32 magic(0);
+	quint32 version(0);
+
+	stream >> magic >> version;
+
+	if (magic != LogMagic || version == 0 || version > LogVersion)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to load history file: unsupported format"), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	if (version < LogVersion)
+	{
+		m_needsCompaction = true;
+	}
+
+	while (!stream.atEnd())
+	{
+		quint8 type(UnknownRecord);
+
+		stream >> type;
+
+		switch (type)
+		{
+			case HostRecord:
+				{
+					quint32 identifier(0);
+					QString host;
+
+					stream >> identifier >> host;
+
+					if (stream.status() == QDataStream::Ok && identifier > 0)
+					{
+						HostEntry entry;
+						entry.host = host;
+
+						m_hosts[identifier] = entry;
+						m_hostIdentifiers[host] = identifier;
+						m_nextHostIdentifier = qMax(m_nextHostIdentifier, (identifier + 1));
+					}
+				}
+
+				break;
+			case UrlRecord:
+				{
+					quint32 identifier(0);
+					quint32 host(0);
+					QUrl url;
+
+					stream >> identifier >> host >> url;
+
+					if (stream.status() == QDataStream::Ok && identifier > 0 && m_hosts.contains(host))
+					{
+						UrlEntry entry;
+						entry.url = url;
+						entry.normalizedUrl = Utils::normalizeUrl(url);
+						entry.host = host;
+
+						m_urls[identifier] = entry;
+						m_urlIdentifiers[url] = identifier;
+						m_normalizedUrls[entry.normalizedUrl].append(identifier);
+						m_hosts[host].urls.append(identifier);
+						m_nextUrlIdentifier = qMax(m_nextUrlIdentifier, (identifier + 1));
+					}
+				}
+
+				break;
+			case VisitRecord:
+				{
+					Visit visit;
+
+					stream >> visit.identifier >> visit.url >> visit.timeVisited >> visit.title;
+
+					if (stream.status() == QDataStream::Ok && visit.isValid() && m_urls.contains(visit.url) && !m_visits.contains(visit.identifier))
+					{
+						insertVisit(visit);
+					}
+				}
+
+				break;
+			case UpdateVisitRecord:
+				{
+					quint64 identifier(0);
+					quint32 url(0);
+					QString title;
+
+					stream >> identifier >> url >> title;
+
+					if (stream.status() == QDataStream::Ok && m_visits.contains(identifier) && m_urls.contains(url))
+					{
+						applyUpdate(identifier, url, title);
+
+						++m_obsoleteRecordsAmount;
+					}
+				}
+
+				break;
+			case RemoveVisitRecord:
+				{
+					quint64 identifier(0);
+
+					stream >> identifier;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						takeVisit(identifier);
+
+						m_obsoleteRecordsAmount += 2;
+					}
+				}
+
+				break;
+			case DownsampleVisitRecord:
+				{
+					quint64 identifier(0);
+
+					stream >> identifier;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						takeVisit(identifier, false);
+
+						m_obsoleteRecordsAmount += 2;
+					}
+				}
+
+				break;
+			case StatisticsRecord:
+				{
+					quint32 url(0);
+					UrlStatistics statistics;
+
+					stream >> url >> statistics.score >> statistics.scoreTime >> statistics.visitsAmount;
+
+					if (stream.status() == QDataStream::Ok && m_urls.contains(url))
+					{
+						m_statistics[m_urls.value(url).normalizedUrl] = statistics;
+
+						++m_obsoleteRecordsAmount;
+					}
+				}
+
+				break;
+			default:
+				stream.setStatus(QDataStream::ReadCorruptData);
+
+				break;
+		}
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Failed to load history file: truncated or corrupted record"), Console::OtherCategory, Console::WarningLevel, m_path);
+
+			m_needsCompaction = true;
+
+			break;
+		}
+	}
+
+	QVector<quint32> orphanedUrls;
+	QHash<quint32, UrlEntry>::const_iterator iterator;
+
+	for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		if (iterator->visits.isEmpty())
+		{
+			orphanedUrls.append(iterator.key());
+		}
+	}
+
+	for (int i = 0; i < orphanedUrls.count(); ++i)
+	{
+		removeUrlVisit(orphanedUrls.at(i), 0);
+	}
+}
+
+void HistoryStore::rebuildIndex()
+{
+	m_index.clear();
+
+	QHash<QUrl, QVector<quint32> >::const_iterator iterator;
+
+	for (iterator = m_normalizedUrls.constBegin(); iterator != m_normalizedUrls.constEnd(); ++iterator)
+	{
+		m_index.addUrl(iterator.key(), getLastVisit(iterator.value()).title, false);
+	}
+
+	m_index.optimize();
+
+	m_isIndexEnabled = true;
+
+	rebuildFilter();
+}
+
+void HistoryStore::rebuildFilter()
+{
+	m_filter.reserve(m_urls.count() * 2);
+
+	QHash<quint32, UrlEntry>::const_iterator iterator;
+
+	for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		m_filter.addUrl(iterator->url);
+		m_filter.addUrl(iterator->normalizedUrl);
+	}
+}
+
+void HistoryStore::clear()
+{
+	m_pendingRecords.clear();
+	m_hosts.clear();
+	m_hostIdentifiers.clear();
+	m_urls.clear();
+	m_urlIdentifiers.clear();
+	m_normalizedUrls.clear();
+	m_statistics.clear();
+	m_visits.clear();
+	m_timeline.clear();
+	m_removedUrls.clear();
+	m_removedHosts.clear();
+	m_index.clear();
+	m_filter.clear();
+
+	m_needsCompaction = true;
+}
+
+void HistoryStore::insertVisit(const Visit &visit)
+{
+	UrlEntry &urlEntry(m_urls[visit.url]);
+	urlEntry.visits.append(visit.identifier);
+
+	m_visits[visit.identifier] = visit;
+	m_nextVisitIdentifier = qMax(m_nextVisitIdentifier, (visit.identifier + 1));
+
+	updateStatistics(urlEntry.normalizedUrl, visit.timeVisited, 1);
+
+	if (m_timeline.isEmpty() || getTimelinePosition(visit.timeVisited, visit.identifier) == m_timeline.count())
+	{
+		m_timeline.append(visit.identifier);
+	}
+	else
+	{
+		m_timeline.insert(getTimelinePosition(visit.timeVisited, visit.identifier), visit.identifier);
+	}
+
+	if (m_isIndexEnabled)
+	{
+		m_index.addUrl(urlEntry.normalizedUrl, visit.title);
+	}
+}
+
+void HistoryStore::applyUpdate(quint64 identifier, quint32 url, const QString &title)
+{
+	Visit &visit(m_visits[identifier]);
+	visit.title = title;
+
+	if (visit.url != url)
+	{
+		const quint32 previousUrl(visit.url);
+
+		visit.url = url;
+
+		m_urls[url].visits.append(identifier);
+
+		updateStatistics(m_urls.value(previousUrl).normalizedUrl, visit.timeVisited, -1);
+		updateStatistics(m_urls.value(url).normalizedUrl, visit.timeVisited, 1);
+
+		removeUrlVisit(previousUrl, identifier);
+	}
+
+	if (m_isIndexEnabled)
+	{
+		m_index.addUrl(m_urls.value(url).normalizedUrl, title);
+	}
+}
+
+void HistoryStore::takeVisit(quint64 identifier, bool canUpdateStatistics)
+{
+	const QHash<quint64, Visit>::iterator visitIterator(m_visits.find(identifier));
+
+	if (visitIterator == m_visits.end())
+	{
+		return;
+	}
+
+	const Visit visit(visitIterator.value());
+	const int position(getTimelinePosition(visit.timeVisited, identifier));
+
+	if (position < m_timeline.count() && m_timeline.at(position) == identifier)
+	{
+		m_timeline.remove(position);
+	}
+
+	m_visits.erase(visitIterator);
+
+	if (canUpdateStatistics)
+	{
+		updateStatistics(m_urls.value(visit.url).normalizedUrl, visit.timeVisited, -1);
+	}
+
+	removeUrlVisit(visit.url, identifier);
+}
+
+void HistoryStore::updateStatistics(const QUrl &url, qint64 timeVisited, double weight)
+{
+	UrlStatistics &statistics(m_statistics[url]);
+
+	if (timeVisited >= statistics.scoreTime)
+	{
+		statistics.score = ((statistics.score * getDecay(timeVisited - statistics.scoreTime)) + weight);
+		statistics.scoreTime = timeVisited;
+	}
+	else
+	{
+		statistics.score += (weight * getDecay(statistics.scoreTime - timeVisited));
+	}
+
+	statistics.score = qMax(0.0, statistics.score);
+	statistics.visitsAmount += ((weight > 0) ? 1 : -1);
+
+	if (statistics.visitsAmount <= 0)
+	{
+		m_statistics.remove(url);
+	}
+}
+
+void HistoryStore::removeUrlVisit(quint32 url, quint64 identifier)
+{
+	const QHash<quint32, UrlEntry>::iterator urlIterator(m_urls.find(url));
+
+	if (urlIterator == m_urls.end())
+	{
+		return;
+	}
+
+	urlIterator->visits.removeOne(identifier);
+
+	if (!urlIterator->visits.isEmpty())
+	{
+		return;
+	}
+
+	const UrlEntry urlEntry(urlIterator.value());
+
+	m_urls.erase(urlIterator);
+	m_urlIdentifiers.remove(urlEntry.url);
+	m_filter.markAsRemoved();
+
+	QVector<quint32> &normalizedUrls(m_normalizedUrls[urlEntry.normalizedUrl]);
+	normalizedUrls.removeOne(url);
+
+	if (normalizedUrls.isEmpty())
+	{
+		m_normalizedUrls.remove(urlEntry.normalizedUrl);
+		m_statistics.remove(urlEntry.normalizedUrl);
+		m_removedUrls.append(urlEntry.normalizedUrl);
+
+		if (m_isIndexEnabled)
+		{
+			m_index.removeUrl(urlEntry.normalizedUrl);
+		}
+	}
+
+	++m_obsoleteRecordsAmount;
+
+	const QHash<quint32, HostEntry>::iterator hostIterator(m_hosts.find(urlEntry.host));
+
+	if (hostIterator == m_hosts.end())
+	{
+		return;
+	}
+
+	hostIterator->urls.removeOne(url);
+
+	if (hostIterator->urls.isEmpty())
+	{
+		m_removedHosts.append(hostIterator->host);
+		m_hostIdentifiers.remove(hostIterator->host);
+		m_hosts.erase(hostIterator);
+
+		++m_obsoleteRecordsAmount;
+	}
+}
+
+void HistoryStore::removeVisit(quint64 identifier)
+{
+	if (!m_visits.contains(identifier))
+	{
+		return;
+	}
+
+	takeVisit(identifier);
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << static_cast<quint8>(RemoveVisitRecord) << identifier;
+
+	m_obsoleteRecordsAmount += 2;
+}
+
+void HistoryStore::removeVisits(const QVector<quint64> &identifiers)
+{
+	QSet<quint64> removedVisits;
+	removedVisits.reserve(identifiers.count());
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		const quint64 identifier(identifiers.at(i));
+		const QHash<quint64, Visit>::iterator iterator(m_visits.find(identifier));
+
+		if (iterator == m_visits.end())
+		{
+			continue;
+		}
+
+		const Visit visit(iterator.value());
+
+		m_visits.erase(iterator);
+
+		updateStatistics(m_urls.value(visit.url).normalizedUrl, visit.timeVisited, -1);
+		removeUrlVisit(visit.url, identifier);
+
+		removedVisits.insert(identifier);
+
+		stream << static_cast<quint8>(RemoveVisitRecord) << identifier;
+	}
+
+	if (removedVisits.isEmpty())
+	{
+		return;
+	}
+
+	m_timeline.erase(std::remove_if(m_timeline.begin(), m_timeline.end(), [&](quint64 identifier)
+	{
+		return removedVisits.contains(identifier);
+	}), m_timeline.end());
+
+	m_obsoleteRecordsAmount += (removedVisits.count() * 2);
+}
+
+QVector<quint64> HistoryStore::downsampleVisits(qint64 time)
+{
+	const int position(getTimelinePosition(time, 0));
+	QHash<quint32, quint64> keptVisits;
+	QVector<quint64> removedVisits;
+
+	for (int i = (position - 1); i >= 0; --i)
+	{
+		const Visit &visit(m_visits.constFind(m_timeline.at(i)).value());
+
+		if (keptVisits.contains(visit.url))
+		{
+			removedVisits.append(visit.identifier);
+		}
+		else
+		{
+			keptVisits[visit.url] = visit.identifier;
+		}
+	}
+
+	if (removedVisits.isEmpty())
+	{
+		return {};
+	}
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	QSet<quint64> removedIdentifiers;
+	removedIdentifiers.reserve(removedVisits.count());
+
+	for (int i = 0; i < removedVisits.count(); ++i)
+	{
+		const quint64 identifier(removedVisits.at(i));
+		const quint32 url(m_visits.value(identifier).url);
+
+		m_visits.remove(identifier);
+		m_urls[url].visits.removeOne(identifier);
+
+		removedIdentifiers.insert(identifier);
+
+		stream << static_cast<quint8>(DownsampleVisitRecord) << identifier;
+	}
+
+	m_timeline.erase(std::remove_if(m_timeline.begin(), m_timeline.end(), [&](quint64 identifier)
+	{
+		return removedIdentifiers.contains(identifier);
+	}), m_timeline.end());
+
+	m_obsoleteRecordsAmount += (removedVisits.count() * 2);
+
+	return removedVisits;
+}
+
+void HistoryStore::updateVisit(quint64 identifier, const QUrl &url, const QString &title)
+{
+	if (!m_visits.contains(identifier))
+	{
+		return;
+	}
+
+	const Visit visit(m_visits.value(identifier));
+
+	if (visit.title == title && m_urls.value(visit.url).url == url)
+	{
+		return;
+	}
+
+	const quint32 urlIdentifier(addUrl(url));
+
+	applyUpdate(identifier, urlIdentifier, title);
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << static_cast<quint8>(UpdateVisitRecord) << identifier << urlIdentifier << title;
+
+	++m_obsoleteRecordsAmount;
+}
+
+void HistoryStore::writeHost(QDataStream &stream, quint32 identifier) const
+{
+	stream << static_cast<quint8>(HostRecord) << identifier << m_hosts.value(identifier).host;
+}
+
+void HistoryStore::writeUrl(QDataStream &stream, quint32 identifier) const
+{
+	const UrlEntry entry(m_urls.value(identifier));
+
+	stream << static_cast<quint8>(UrlRecord) << identifier << entry.host << entry.url;
+}
+
+void HistoryStore::writeVisit(QDataStream &stream, const Visit &visit) const
+{
+	stream << static_cast<quint8>(VisitRecord) << visit.identifier << visit.url << visit.timeVisited << visit.title;
+}
+
+void HistoryStore::writeStatistics(QDataStream &stream, quint32 url, const UrlStatistics &statistics) const
+{
+	stream << static_cast<quint8>(StatisticsRecord) << url << statistics.score << statistics.scoreTime << statistics.visitsAmount;
+}
+
+HistoryStore::UrlEntry HistoryStore::getUrlEntry(quint32 identifier) const
+{
+	return m_urls.value(identifier);
+}
+
+HistoryStore::Visit HistoryStore::getVisit(quint64 identifier) const
+{
+	return m_visits.value(identifier);
+}
+
+HistoryStore::Visit HistoryStore::getLastVisit(const QUrl &url) const
+{
+	return getLastVisit(m_normalizedUrls.value(Utils::normalizeUrl(url)));
+}
+
+HistoryStore::Visit HistoryStore::getLastVisit(const QVector<quint32> &urls) const
+{
+	Visit lastVisit;
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const QVector<quint64> visits(m_urls.value(urls.at(i)).visits);
+
+		for (int j = 0; j < visits.count(); ++j)
+		{
+			const QHash<quint64, Visit>::const_iterator iterator(m_visits.constFind(visits.at(j)));
+
+			if (iterator != m_visits.constEnd() && (!lastVisit.isValid() || iterator->timeVisited > lastVisit.timeVisited))
+			{
+				lastVisit = iterator.value();
+			}
+		}
+	}
+
+	return lastVisit;
+}
+
+QVector<HistoryStore::Visit> HistoryStore::findVisits(const QString &prefix, int limit, const std::function<double(const QUrl &url)> &getWeight) const
+{
+	const QVector<QUrl> urls(m_index.findPrefix(prefix));
+	const qint64 time(QDateTime::currentMSecsSinceEpoch());
+	const auto compare([&](const QPair<double, Visit> &first, const QPair<double, Visit> &second)
+	{
+		if (first.first != second.first)
+		{
+			return (first.first > second.first);
+		}
+
+		return (first.second.timeVisited > second.second.timeVisited);
+	});
+	QVector<QPair<double, Visit> > rankedVisits;
+	rankedVisits.reserve((limit > 0) ? qMin(limit, urls.count()) : urls.count());
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const Visit visit(getLastVisit(m_normalizedUrls.value(urls.at(i))));
+
+		if (!visit.isValid())
+		{
+			continue;
+		}
+
+		const QPair<double, Visit> rankedVisit((getFrecency(visit.url, time) * (getWeight ? getWeight(m_urls.value(visit.url).url) : 1)), visit);
+
+		if (limit <= 0 || rankedVisits.count() < limit)
+		{
+			rankedVisits.append(rankedVisit);
+
+			if (limit > 0)
+			{
+				std::push_heap(rankedVisits.begin(), rankedVisits.end(), compare);
+			}
+		}
+		else if (compare(rankedVisit, rankedVisits.first()))
+		{
+			std::pop_heap(rankedVisits.begin(), rankedVisits.end(), compare);
+
+			rankedVisits.last() = rankedVisit;
+
+			std::push_heap(rankedVisits.begin(), rankedVisits.end(), compare);
+		}
+	}
+
+	if (limit > 0)
+	{
+		std::sort_heap(rankedVisits.begin(), rankedVisits.end(), compare);
+	}
+	else
+	{
+		std::sort(rankedVisits.begin(), rankedVisits.end(), compare);
+	}
+
+	QVector<Visit> visits;
+	visits.reserve(rankedVisits.count());
+
+	for (int i = 0; i < rankedVisits.count(); ++i)
+	{
+		visits.append(rankedVisits.at(i).second);
+	}
+
+	return visits;
+}
+
+QVector<HistoryStore::Visit> HistoryStore::findVisitsContaining(const QString &text, int limit) const
+{
+	const QVector<QUrl> urls(m_index.findSubstring(text, limit));
+	QVector<Visit> visits;
+	visits.reserve(urls.count());
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const Visit visit(getLastVisit(m_normalizedUrls.value(urls.at(i))));
+
+		if (visit.isValid())
+		{
+			visits.append(visit);
+		}
+	}
+
+	return visits;
+}
+
+QVector<HistoryStore::Visit> HistoryStore::findMatchingVisits(const QString &text) const
+{
+	QVector<Visit> visits;
+
+	if (m_isIndexEnabled && text.length() >= 3)
+	{
+		const QVector<QUrl> urls(m_index.findSubstring(text, m_normalizedUrls.count()));
+
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			const QVector<quint32> identifiers(m_normalizedUrls.value(urls.at(i)));
+
+			for (int j = 0; j < identifiers.count(); ++j)
+			{
+				const QVector<quint64> urlVisits(m_urls.value(identifiers.at(j)).visits);
+
+				for (int k = 0; k < urlVisits.count(); ++k)
+				{
+					const QHash<quint64, Visit>::const_iterator iterator(m_visits.constFind(urlVisits.at(k)));
+
+					if (iterator != m_visits.constEnd())
+					{
+						visits.append(iterator.value());
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		QHash<quint64, Visit>::const_iterator iterator;
+
+		for (iterator = m_visits.constBegin(); iterator != m_visits.constEnd(); ++iterator)
+		{
+			if (iterator->title.contains(text, Qt::CaseInsensitive) || m_urls.value(iterator->url).url.toString().contains(text, Qt::CaseInsensitive))
+			{
+				visits.append(iterator.value());
+			}
+		}
+	}
+
+	std::sort(visits.begin(), visits.end(), [&](const Visit &first, const Visit &second)
+	{
+		return (first.timeVisited > second.timeVisited || (first.timeVisited == second.timeVisited && first.identifier > second.identifier));
+	});
+
+	return visits;
+}
+
+QVector<HistoryStore::Visit> HistoryStore::getVisits(qint64 timeVisited, quint64 identifier, int amount) const
+{
+	const int position(getTimelinePosition(timeVisited, identifier));
+	QVector<Visit> visits;
+	visits.reserve(qMin(amount, position));
+
+	for (int i = (position - 1); i >= qMax(0, (position - amount)); --i)
+	{
+		visits.append(m_visits.value(m_timeline.at(i)));
+	}
+
+	return visits;
+}
+
+QVector<quint64> HistoryStore::getUrlVisits(const QUrl &url) const
+{
+	const QVector<quint32> urls(m_normalizedUrls.value(Utils::normalizeUrl(url)));
+	QVector<quint64> visits;
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		visits.append(m_urls.value(urls.at(i)).visits);
+	}
+
+	return visits;
+}
+
+QVector<quint64> HistoryStore::getHostVisits(const QString &host) const
+{
+	const QVector<quint32> urls(m_hosts.value(m_hostIdentifiers.value(host)).urls);
+	QVector<quint64> visits;
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		visits.append(m_urls.value(urls.at(i)).visits);
+	}
+
+	return visits;
+}
+
+QVector<quint64> HistoryStore::getVisitsRange(qint64 from, qint64 to) const
+{
+	const int position(getTimelinePosition(from, 0));
+
+	return m_timeline.mid(position, (getTimelinePosition(to, 0) - position));
+}
+
+QVector<quint64> HistoryStore::getOldestVisits(int amount) const
+{
+	return m_timeline.mid(0, amount);
+}
+
+quint32 HistoryStore::addHost(const QString &host)
+{
+	if (m_hostIdentifiers.contains(host))
+	{
+		return m_hostIdentifiers[host];
+	}
+
+	const quint32 identifier(m_nextHostIdentifier);
+	HostEntry entry;
+	entry.host = host;
+
+	m_hosts[identifier] = entry;
+	m_hostIdentifiers[host] = identifier;
+
+	++m_nextHostIdentifier;
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	writeHost(stream, identifier);
+
+	return identifier;
+}
+
+quint32 HistoryStore::addUrl(const QUrl &url)
+{
+	if (m_urlIdentifiers.contains(url))
+	{
+		return m_urlIdentifiers[url];
+	}
+
+	const quint32 identifier(m_nextUrlIdentifier);
+	UrlEntry entry;
+	entry.url = url;
+	entry.normalizedUrl = Utils::normalizeUrl(url);
+	entry.host = addHost(Utils::extractHost(url));
+
+	m_urls[identifier] = entry;
+	m_urlIdentifiers[url] = identifier;
+	m_normalizedUrls[entry.normalizedUrl].append(identifier);
+	m_hosts[entry.host].urls.append(identifier);
+
+	if (m_isIndexEnabled)
+	{
+		m_filter.addUrl(url);
+		m_filter.addUrl(entry.normalizedUrl);
+
+		if (m_filter.needsRebuild())
+		{
+			rebuildFilter();
+		}
+	}
+
+	++m_nextUrlIdentifier;
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	writeUrl(stream, identifier);
+
+	return identifier;
+}
+
+QVector<QUrl> HistoryStore::takeRemovedUrls()
+{
+	QVector<QUrl> urls;
+	urls.reserve(m_removedUrls.count());
+
+	for (int i = 0; i < m_removedUrls.count(); ++i)
+	{
+		if (!m_normalizedUrls.contains(m_removedUrls.at(i)))
+		{
+			urls.append(m_removedUrls.at(i));
+		}
+	}
+
+	m_removedUrls.clear();
+
+	return urls;
+}
+
+QStringList HistoryStore::takeRemovedHosts()
+{
+	QStringList hosts;
+	hosts.reserve(m_removedHosts.count());
+
+	for (int i = 0; i < m_removedHosts.count(); ++i)
+	{
+		if (!m_hostIdentifiers.contains(m_removedHosts.at(i)))
+		{
+			hosts.append(m_removedHosts.at(i));
+		}
+	}
+
+	m_removedHosts.clear();
+
+	return hosts;
+}
+
+quint64 HistoryStore::addVisit(const QUrl &url, const QString &title, qint64 timeVisited, quint64 identifier)
+{
+	if (identifier == 0 || m_visits.contains(identifier))
+	{
+		identifier = m_nextVisitIdentifier;
+	}
+
+	Visit visit;
+	visit.title = title;
+	visit.timeVisited = timeVisited;
+	visit.identifier = identifier;
+	visit.url = addUrl(url);
+
+	insertVisit(visit);
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	writeVisit(stream, visit);
+
+	return identifier;
+}
+
+double HistoryStore::getFrecency(quint32 url, qint64 time) const
+{
+	const QHash<quint32, UrlEntry>::const_iterator urlIterator(m_urls.constFind(url));
+
+	if (urlIterator == m_urls.constEnd())
+	{
+		return 0;
+	}
+
+	const QHash<QUrl, UrlStatistics>::const_iterator statisticsIterator(m_statistics.constFind(urlIterator->normalizedUrl));
+
+	if (statisticsIterator == m_statistics.constEnd())
+	{
+		return 0;
+	}
+
+	return (statisticsIterator->score * getDecay(qMax(Q_INT64_C(0), (time - statisticsIterator->scoreTime))));
+}
+
+double HistoryStore::getDecay(qint64 interval)
+{
+	return std::pow(0.5, (static_cast<double>(interval) / 2592000000.0));
+}
+
+int HistoryStore::getTimelinePosition(qint64 timeVisited, quint64 identifier) const
+{
+	return static_cast<int>(std::lower_bound(m_timeline.constBegin(), m_timeline.constEnd(), identifier, [&](quint64 current, quint64)
+	{
+		const qint64 currentTimeVisited(m_visits.constFind(current)->timeVisited);
+
+		return (currentTimeVisited < timeVisited || (currentTimeVisited == timeVisited && current < identifier));
+	}) - m_timeline.constBegin());
+}
+
+int HistoryStore::getVisitsAmount() const
+{
+	return m_visits.count();
+}
+
+bool HistoryStore::importJson(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
+	}
+
+	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+
+	file.close();
+
+	m_timeline.reserve(m_timeline.count() + historyArray.count());
+
+	m_isIndexEnabled = false;
+
+	for (int i = 0; i < historyArray.count(); ++i)
+	{
+		const QJsonObject entryObject(historyArray.at(i).toObject());
+		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
+		dateTime.setTimeSpec(Qt::UTC);
+
+		addVisit(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), dateTime.toMSecsSinceEpoch());
+	}
+
+	rebuildIndex();
+
+	m_needsCompaction = true;
+
+	return true;
+}
+
+bool HistoryStore::compact()
+{
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << LogMagic << LogVersion;
+
+	QHash<quint32, HostEntry>::const_iterator hostsIterator;
+
+	for (hostsIterator = m_hosts.constBegin(); hostsIterator != m_hosts.constEnd(); ++hostsIterator)
+	{
+		writeHost(stream, hostsIterator.key());
+	}
+
+	QHash<quint32, UrlEntry>::const_iterator urlsIterator;
+
+	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	{
+		writeUrl(stream, urlsIterator.key());
+	}
+
+	for (int i = 0; i < m_timeline.count(); ++i)
+	{
+		writeVisit(stream, m_visits.value(m_timeline.at(i)));
+	}
+
+	QHash<QUrl, QVector<quint32> >::const_iterator normalizedUrlsIterator;
+
+	for (normalizedUrlsIterator = m_normalizedUrls.constBegin(); normalizedUrlsIterator != m_normalizedUrls.constEnd(); ++normalizedUrlsIterator)
+	{
+		const QHash<QUrl, UrlStatistics>::const_iterator statisticsIterator(m_statistics.constFind(normalizedUrlsIterator.key()));
+
+		if (statisticsIterator != m_statistics.constEnd() && !normalizedUrlsIterator->isEmpty())
+		{
+			writeStatistics(stream, normalizedUrlsIterator->first(), statisticsIterator.value());
+		}
+	}
+
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	m_pendingRecords.clear();
+
+	m_obsoleteRecordsAmount = 0;
+	m_needsCompaction = false;
+
+	return true;
+}
+
+bool HistoryStore::flush()
+{
+	if (m_filter.needsRebuild())
+	{
+		rebuildFilter();
+	}
+
+	if (SessionsManager::isReadOnly())
+	{
+		return false;
+	}
+
+	if (m_needsCompaction || !QFile::exists(m_path) || (m_obsoleteRecordsAmount > 1000 && m_obsoleteRecordsAmount > m_visits.count()))
+	{
+		return compact();
+	}
+
+	if (m_pendingRecords.isEmpty())
+	{
+		return true;
+	}
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	if (file.write(m_pendingRecords) != m_pendingRecords.size())
+	{
+		m_needsCompaction = true;
+
+		return false;
+	}
+
+	m_pendingRecords.clear();
+
+	return true;
+}
+
+bool HistoryStore::hasUrl(const QUrl &url) const
+{
+	return m_normalizedUrls.contains(Utils::normalizeUrl(url));
+}
+
+bool HistoryStore::mayHaveUrl(const QString &url) const
+{
+	return m_filter.mayContain(url);
+}
+
+bool HistoryStore::hasVisit(quint64 identifier) const
+{
+	return m_visits.contains(identifier);
+}
+
+}
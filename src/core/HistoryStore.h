@@ -0,0 +1,163 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYSTORE_H
+#define OTTER_HISTORYSTORE_H
+
+#include "HistoryIndex.h"
+#include "VisitedUrlsFilter.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+#include <functional>
+
+namespace Otter
+{
+
+class HistoryStore final
+{
+public:
+	struct Visit final
+	{
+		QString title;
+		qint64 timeVisited = 0;
+		quint64 identifier = 0;
+		quint32 url = 0;
+
+		bool isValid() const
+		{
+			return (identifier > 0);
+		}
+	};
+
+	struct UrlEntry final
+	{
+		QUrl url;
+		QUrl normalizedUrl;
+		QVector<quint64> visits;
+		quint32 host = 0;
+	};
+
+	struct HostEntry final
+	{
+		QString host;
+		QVector<quint32> urls;
+	};
+
+	struct UrlStatistics final
+	{
+		double score = 0;
+		qint64 scoreTime = 0;
+		int visitsAmount = 0;
+	};
+
+	explicit HistoryStore(const QString &path);
+
+	void clear();
+	void removeVisit(quint64 identifier);
+	void removeVisits(const QVector<quint64> &identifiers);
+	void updateVisit(quint64 identifier, const QUrl &url, const QString &title);
+	UrlEntry getUrlEntry(quint32 identifier) const;
+	Visit getVisit(quint64 identifier) const;
+	Visit getLastVisit(const QUrl &url) const;
+	QVector<Visit> findVisits(const QString &prefix, int limit = 0, const std::function<double(const QUrl &url)> &getWeight = nullptr) const;
+	QVector<Visit> findVisitsContaining(const QString &text, int limit) const;
+	QVector<Visit> findMatchingVisits(const QString &text) const;
+	QVector<Visit> getVisits(qint64 timeVisited, quint64 identifier, int amount) const;
+	QVector<quint64> getUrlVisits(const QUrl &url) const;
+	QVector<quint64> getHostVisits(const QString &host) const;
+	QVector<quint64> getVisitsRange(qint64 from, qint64 to) const;
+	QVector<quint64> getOldestVisits(int amount) const;
+	QVector<quint64> downsampleVisits(qint64 time);
+	QVector<QUrl> takeRemovedUrls();
+	QStringList takeRemovedHosts();
+	quint64 addVisit(const QUrl &url, const QString &title, qint64 timeVisited, quint64 identifier = 0);
+	double getFrecency(quint32 url, qint64 time) const;
+	int getVisitsAmount() const;
+	bool importJson(const QString &path);
+	bool flush();
+	bool hasUrl(const QUrl &url) const;
+	bool mayHaveUrl(const QString &url) const;
+	bool hasVisit(quint64 identifier) const;
+
+protected:
+	enum RecordType
+	{
+		UnknownRecord = 0,
+		HostRecord,
+		UrlRecord,
+		VisitRecord,
+		UpdateVisitRecord,
+		RemoveVisitRecord,
+		DownsampleVisitRecord,
+		StatisticsRecord
+	};
+
+	void load();
+	void rebuildIndex();
+	void rebuildFilter();
+	void insertVisit(const Visit &visit);
+	void applyUpdate(quint64 identifier, quint32 url, const QString &title);
+	void takeVisit(quint64 identifier, bool canUpdateStatistics = true);
+	void removeUrlVisit(quint32 url, quint64 identifier);
+	void updateStatistics(const QUrl &url, qint64 timeVisited, double weight);
+	void writeHost(QDataStream &stream, quint32 identifier) const;
+	void writeUrl(QDataStream &stream, quint32 identifier) const;
+	void writeVisit(QDataStream &stream, const Visit &visit) const;
+	void writeStatistics(QDataStream &stream, quint32 url, const UrlStatistics &statistics) const;
+	quint32 addHost(const QString &host);
+	quint32 addUrl(const QUrl &url);
+	Visit getLastVisit(const QVector<quint32> &urls) const;
+	int getTimelinePosition(qint64 timeVisited, quint64 identifier) const;
+	static double getDecay(qint64 interval);
+	bool compact();
+
+private:
+	QString m_path;
+	QByteArray m_pendingRecords;
+	HistoryIndex m_index;
+	VisitedUrlsFilter m_filter;
+	QHash<quint32, HostEntry> m_hosts;
+	QHash<QString, quint32> m_hostIdentifiers;
+	QHash<quint32, UrlEntry> m_urls;
+	QHash<QUrl, quint32> m_urlIdentifiers;
+	QHash<QUrl, QVector<quint32> > m_normalizedUrls;
+	QHash<QUrl, UrlStatistics> m_statistics;
+	QHash<quint64, Visit> m_visits;
+	QVector<quint64> m_timeline;
+	QVector<QUrl> m_removedUrls;
+	QStringList m_removedHosts;
+	quint64 m_nextVisitIdentifier;
+	quint32 m_nextUrlIdentifier;
+	quint32 m_nextHostIdentifier;
+	int m_obsoleteRecordsAmount;
+	bool m_isIndexEnabled;
+	bool m_needsCompaction;
+
+	static const quint32 LogMagic;
+	static const quint32 LogVersion;
+};
+
+}
+
+#endif
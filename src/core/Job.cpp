@@ -18,10 +18,13 @@
 **************************************************************************/
 
 #include "Job.h"
+#include "HistoryManager.h"
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
 #include "Utils.h"
 
+#include <QtCore/QTimer>
+
 namespace Otter
 {
 
@@ -58,7 +61,10 @@ FetchJob::FetchJob(const QUrl &url, QObject *parent) : Job(parent),
 
 FetchJob::~FetchJob()
 {
-	m_reply->deleteLater();
+	if (m_reply)
+	{
+		m_reply->deleteLater();
+	}
 }
 
 void FetchJob::timerEvent(QTimerEvent *event)
@@ -79,7 +85,7 @@ void FetchJob::start()
 		return;
 	}
 
-	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate);
+	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate, nullptr, m_headers);
 
 	connect(m_reply, &QNetworkReply::downloadProgress, this, [&](qint64 bytesReceived, qint64 bytesTotal)
 	{
@@ -113,8 +119,11 @@ void FetchJob::start()
 
 void FetchJob::cancel()
 {
-	m_reply->blockSignals(true);
-	m_reply->abort();
+	if (m_reply)
+	{
+		m_reply->blockSignals(true);
+		m_reply->abort();
+	}
 
 	deleteLater();
 
@@ -151,11 +160,21 @@ void FetchJob::setPrivate(bool isPrivate)
 	m_isPrivate = isPrivate;
 }
 
+void FetchJob::setHeader(const QByteArray &name, const QByteArray &value)
+{
+	m_headers[name] = value;
+}
+
 QUrl FetchJob::getUrl() const
 {
 	return (m_reply ? m_reply->request().url() : m_url);
 }
 
+bool FetchJob::isPrivate() const
+{
+	return m_isPrivate;
+}
+
 bool FetchJob::isRunning() const
 {
 	return (m_reply != nullptr);
@@ -178,6 +197,11 @@ QIODevice* DataFetchJob::getData() const
 	return m_reply;
 }
 
+QByteArray DataFetchJob::getHeader(const QByteArray &name) const
+{
+	return (m_reply ? m_reply->rawHeader(name) : QByteArray());
+}
+
 QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 {
 	QMap<QByteArray, QByteArray> headers;
@@ -193,12 +217,41 @@ QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 	return headers;
 }
 
+int DataFetchJob::getStatusCode() const
+{
+	return (m_reply ? m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0);
+}
+
 IconFetchJob::IconFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent)
 {
 	setSizeLimit(20480);
 	setTimeout(5);
 }
 
+void IconFetchJob::start()
+{
+	if (!isRunning() && !isPrivate())
+	{
+		const QIcon icon(HistoryManager::getStoredIcon(getUrl()));
+
+		if (!icon.isNull())
+		{
+			m_icon = icon;
+
+			QTimer::singleShot(0, this, [&]()
+			{
+				deleteLater();
+
+				emit jobFinished(true);
+			});
+
+			return;
+		}
+	}
+
+	FetchJob::start();
+}
+
 void IconFetchJob::handleSuccessfulReply(QNetworkReply *reply)
 {
 	QPixmap pixmap;
@@ -212,6 +265,10 @@ void IconFetchJob::handleSuccessfulReply(QNetworkReply *reply)
 	{
 		markAsFailure();
 	}
+	else if (!isPrivate())
+	{
+		HistoryManager::setIcon(reply->request().url(), m_icon);
+	}
 
 	markAsFinished();
 }
@@ -62,6 +62,7 @@ public:
 	void setTimeout(int seconds);
 	void setSizeLimit(qint64 limit);
 	void setPrivate(bool isPrivate);
+	void setHeader(const QByteArray &name, const QByteArray &value);
 	QUrl getUrl() const;
 	bool isRunning() const override;
 
@@ -73,11 +74,13 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	void markAsFailure();
 	void markAsFinished();
+	bool isPrivate() const;
 	virtual void handleSuccessfulReply(QNetworkReply *reply) = 0;
 
 private:
 	QNetworkReply *m_reply;
 	QUrl m_url;
+	QMap<QByteArray, QByteArray> m_headers;
 	qint64 m_sizeLimit;
 	int m_timeoutTimer;
 	bool m_isFinished;
@@ -93,7 +96,9 @@ public:
 	explicit DataFetchJob(const QUrl &url, QObject *parent = nullptr);
 
 	QIODevice* getData() const;
+	QByteArray getHeader(const QByteArray &name) const;
 	QMap<QByteArray, QByteArray> getHeaders() const;
+	int getStatusCode() const;
 
 protected:
 	void handleSuccessfulReply(QNetworkReply *reply) override;
@@ -111,6 +116,9 @@ public:
 
 	QIcon getIcon() const;
 
+public slots:
+	void start() override;
+
 protected:
 	void handleSuccessfulReply(QNetworkReply *reply) override;
 
@@ -50,6 +50,8 @@ CookieJar* NetworkManagerFactory::m_cookieJar(nullptr);
 QString NetworkManagerFactory::m_acceptLanguage;
 QMap<QString, ProxyDefinition> NetworkManagerFactory::m_proxies;
 QMap<QString, UserAgentDefinition> NetworkManagerFactory::m_userAgents;
+QHash<QString, NetworkManagerFactory::NetworkPolicy> NetworkManagerFactory::m_networkPolicies;
+QVector<int> NetworkManagerFactory::m_networkPolicyOptions({SettingsManager::ContentBlocking_EnableContentBlockingOption, SettingsManager::ContentBlocking_IgnoreHostsOption, SettingsManager::ContentBlocking_ProfilesOption, SettingsManager::Network_AcceptLanguageOption, SettingsManager::Network_CookiesKeepModeOption, SettingsManager::Network_CookiesPolicyOption, SettingsManager::Network_DoNotTrackPolicyOption, SettingsManager::Network_EnableReferrerOption, SettingsManager::Network_ProxyOption, SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption, SettingsManager::Network_ThirdPartyCookiesPolicyOption, SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption, SettingsManager::Network_UserAgentOption, SettingsManager::Network_WorkOfflineOption, SettingsManager::Permissions_EnableImagesOption});
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy);
 QList<QSslCipher> NetworkManagerFactory::m_defaultCiphers;
 bool NetworkManagerFactory::m_canSendReferrer(true);
@@ -273,6 +275,7 @@ void NetworkManagerFactory::initialize()
 	m_instance->handleOptionChanged(SettingsManager::Security_CiphersOption, SettingsManager::getOption(SettingsManager::Security_CiphersOption));
 
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, m_instance, &NetworkManagerFactory::handleOptionChanged);
+	connect(SettingsManager::getInstance(), &SettingsManager::hostOptionChanged, m_instance, &NetworkManagerFactory::handleHostOptionChanged);
 }
 
 void NetworkManagerFactory::clearCookies(int period)
@@ -347,6 +350,7 @@ void NetworkManagerFactory::loadUserAgents()
 	m_userAgents[QLatin1String("root")] = root;
 
 	updateUserAgentsOption();
+	clearNetworkPolicies();
 }
 
 void NetworkManagerFactory::readProxy(const QJsonValue &value, ProxyDefinition *parent)
@@ -498,6 +502,11 @@ void NetworkManagerFactory::readUserAgent(const QJsonValue &value, UserAgentDefi
 
 void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &value)
 {
+	if (m_networkPolicyOptions.contains(identifier))
+	{
+		clearNetworkPolicies();
+	}
+
 	switch (identifier)
 	{
 		case SettingsManager::Network_AcceptLanguageOption:
@@ -505,22 +514,7 @@ void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &
 
 			break;
 		case SettingsManager::Network_DoNotTrackPolicyOption:
-			{
-				const QString policyValue(value.toString());
-
-				if (policyValue == QLatin1String("allow"))
-				{
-					m_doNotTrackPolicy = AllowToTrackPolicy;
-				}
-				else if (policyValue == QLatin1String("doNotAllow"))
-				{
-					m_doNotTrackPolicy = DoNotAllowToTrackPolicy;
-				}
-				else
-				{
-					m_doNotTrackPolicy = SkipTrackPolicy;
-				}
-			}
+			m_doNotTrackPolicy = getDoNotTrackPolicy(value.toString());
 
 			break;
 		case SettingsManager::Network_EnableReferrerOption:
@@ -571,6 +565,19 @@ void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &
 	}
 }
 
+void NetworkManagerFactory::handleHostOptionChanged(int identifier)
+{
+	if (m_networkPolicyOptions.contains(identifier))
+	{
+		clearNetworkPolicies();
+	}
+}
+
+void NetworkManagerFactory::clearNetworkPolicies()
+{
+	m_networkPolicies.clear();
+}
+
 void NetworkManagerFactory::notifyAuthenticated(QAuthenticator *authenticator, bool wasAccepted)
 {
 	emit m_instance->authenticated(authenticator, wasAccepted);
@@ -661,12 +668,19 @@ CookieJar* NetworkManagerFactory::getCookieJar()
 	return m_cookieJar;
 }
 
-QNetworkReply* NetworkManagerFactory::createRequest(const QUrl &url, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData)
+QNetworkReply* NetworkManagerFactory::createRequest(const QUrl &url, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData, const QMap<QByteArray, QByteArray> &headers)
 {
 	QNetworkRequest request(url);
 	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
 	request.setHeader(QNetworkRequest::UserAgentHeader, getUserAgent());
 
+	QMap<QByteArray, QByteArray>::const_iterator iterator;
+
+	for (iterator = headers.constBegin(); iterator != headers.constEnd(); ++iterator)
+	{
+		request.setRawHeader(iterator.key(), iterator.value());
+	}
+
 	return getNetworkManager(isPrivate)->createRequest(operation, request, outgoingData);
 }
 
@@ -757,11 +771,111 @@ UserAgentDefinition NetworkManagerFactory::getUserAgent(const QString &identifie
 	return m_userAgents[identifier];
 }
 
+NetworkManagerFactory::NetworkPolicy NetworkManagerFactory::getNetworkPolicy(const QString &host, const QHash<int, QVariant> &options)
+{
+	QHash<int, QVariant>::const_iterator iterator;
+
+	for (iterator = options.constBegin(); iterator != options.constEnd(); ++iterator)
+	{
+		if (m_networkPolicyOptions.contains(iterator.key()))
+		{
+			return createNetworkPolicy(host, options);
+		}
+	}
+
+	if (!m_networkPolicies.contains(host))
+	{
+		if (m_networkPolicies.count() >= 1000)
+		{
+			m_networkPolicies.clear();
+		}
+
+		m_networkPolicies[host] = createNetworkPolicy(host, {});
+	}
+
+	return m_networkPolicies[host];
+}
+
+NetworkManagerFactory::NetworkPolicy NetworkManagerFactory::createNetworkPolicy(const QString &host, const QHash<int, QVariant> &options)
+{
+	const auto getOption([&](int identifier)
+	{
+		return (options.contains(identifier) ? options[identifier] : SettingsManager::getOption(identifier, host));
+	});
+	const QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption).toString());
+	const QString keepModeValue(getOption(SettingsManager::Network_CookiesKeepModeOption).toString());
+	NetworkPolicy policy;
+	policy.acceptLanguage = (acceptLanguage.isEmpty() ? QLatin1String(" ") : QString(acceptLanguage).replace(QLatin1String("system"), QLocale::system().bcp47Name()));
+	policy.proxy = getOption(SettingsManager::Network_ProxyOption).toString();
+	policy.userAgent = getUserAgent(getOption(SettingsManager::Network_UserAgentOption).toString()).value;
+	policy.unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption).toStringList();
+	policy.thirdPartyCookiesAcceptedHosts = getOption(SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption).toStringList();
+	policy.thirdPartyCookiesRejectedHosts = getOption(SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption).toStringList();
+	policy.cookiesPolicy = getCookiesPolicy(getOption(SettingsManager::Network_CookiesPolicyOption).toString());
+	policy.thirdPartyCookiesPolicy = getCookiesPolicy(getOption(SettingsManager::Network_ThirdPartyCookiesPolicyOption).toString());
+	policy.doNotTrackPolicy = getDoNotTrackPolicy(getOption(SettingsManager::Network_DoNotTrackPolicyOption).toString());
+	policy.areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption).toString() != QLatin1String("disabled"));
+	policy.canSendReferrer = getOption(SettingsManager::Network_EnableReferrerOption).toBool();
+	policy.hasProxyOverride = (options.contains(SettingsManager::Network_ProxyOption) || SettingsManager::hasOverride(host, SettingsManager::Network_ProxyOption));
+	policy.isWorkingOffline = getOption(SettingsManager::Network_WorkOfflineOption).toBool();
+
+	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption).toBool())
+	{
+		policy.contentBlockingProfiles = getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList();
+	}
+
+	if (keepModeValue == QLatin1String("keepUntilExit"))
+	{
+		policy.cookiesKeepMode = CookieJar::KeepUntilExitMode;
+	}
+	else if (keepModeValue == QLatin1String("ask"))
+	{
+		policy.cookiesKeepMode = CookieJar::AskIfKeepMode;
+	}
+
+	return policy;
+}
+
+CookieJar::CookiesPolicy NetworkManagerFactory::getCookiesPolicy(const QString &value)
+{
+	if (value == QLatin1String("ignore"))
+	{
+		return CookieJar::IgnoreCookies;
+	}
+
+	if (value == QLatin1String("readOnly"))
+	{
+		return CookieJar::ReadOnlyCookies;
+	}
+
+	if (value == QLatin1String("acceptExisting"))
+	{
+		return CookieJar::AcceptExistingCookies;
+	}
+
+	return CookieJar::AcceptAllCookies;
+}
+
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::getDoNotTrackPolicy()
 {
 	return m_doNotTrackPolicy;
 }
 
+NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::getDoNotTrackPolicy(const QString &value)
+{
+	if (value == QLatin1String("allow"))
+	{
+		return AllowToTrackPolicy;
+	}
+
+	if (value == QLatin1String("doNotAllow"))
+	{
+		return DoNotAllowToTrackPolicy;
+	}
+
+	return SkipTrackPolicy;
+}
+
 bool NetworkManagerFactory::canSendReferrer()
 {
 	return m_canSendReferrer;
@@ -21,6 +21,7 @@
 #ifndef OTTER_NETWORKMANAGERFACTORY_H
 #define OTTER_NETWORKMANAGERFACTORY_H
 
+#include "CookieJar.h"
 #include "ItemModel.h"
 
 #include <QtCore/QCoreApplication>
@@ -129,7 +130,6 @@ struct UserAgentDefinition final
 	}
 };
 
-class CookieJar;
 class NetworkCache;
 class NetworkManager;
 class NetworkManagerFactory;
@@ -186,6 +186,25 @@ public:
 
 	Q_ENUM(DoNotTrackPolicy)
 
+	struct NetworkPolicy final
+	{
+		QString acceptLanguage;
+		QString proxy;
+		QString userAgent;
+		QStringList contentBlockingProfiles;
+		QStringList unblockedHosts;
+		QStringList thirdPartyCookiesAcceptedHosts;
+		QStringList thirdPartyCookiesRejectedHosts;
+		CookieJar::CookiesPolicy cookiesPolicy = CookieJar::AcceptAllCookies;
+		CookieJar::CookiesPolicy thirdPartyCookiesPolicy = CookieJar::AcceptAllCookies;
+		CookieJar::KeepMode cookiesKeepMode = CookieJar::KeepUntilExpiresMode;
+		DoNotTrackPolicy doNotTrackPolicy = SkipTrackPolicy;
+		bool areImagesEnabled = true;
+		bool canSendReferrer = true;
+		bool hasProxyOverride = false;
+		bool isWorkingOffline = false;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void clearCookies(int period = 0);
@@ -197,7 +216,7 @@ public:
 	static NetworkManager* getNetworkManager(bool isPrivate = false);
 	static NetworkCache* getCache();
 	static CookieJar* getCookieJar();
-	static QNetworkReply* createRequest(const QUrl &url, QNetworkAccessManager::Operation operation = QNetworkAccessManager::GetOperation, bool isPrivate = false, QIODevice *outgoingData = nullptr);
+	static QNetworkReply* createRequest(const QUrl &url, QNetworkAccessManager::Operation operation = QNetworkAccessManager::GetOperation, bool isPrivate = false, QIODevice *outgoingData = nullptr, const QMap<QByteArray, QByteArray> &headers = {});
 	static QString getAcceptLanguage();
 	static QString getUserAgent();
 	static QStringList getProxies();
@@ -205,6 +224,7 @@ public:
 	static QList<QSslCipher> getDefaultCiphers();
 	static ProxyDefinition getProxy(const QString &identifier);
 	static UserAgentDefinition getUserAgent(const QString &identifier);
+	static NetworkPolicy getNetworkPolicy(const QString &host, const QHash<int, QVariant> &options = {});
 	static DoNotTrackPolicy getDoNotTrackPolicy();
 	static bool canSendReferrer();
 	static bool isWorkingOffline();
@@ -218,9 +238,14 @@ protected:
 	static void readUserAgent(const QJsonValue &value, UserAgentDefinition *parent);
 	static void updateProxiesOption();
 	static void updateUserAgentsOption();
+	static void clearNetworkPolicies();
+	static NetworkPolicy createNetworkPolicy(const QString &host, const QHash<int, QVariant> &options);
+	static CookieJar::CookiesPolicy getCookiesPolicy(const QString &value);
+	static DoNotTrackPolicy getDoNotTrackPolicy(const QString &value);
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleHostOptionChanged(int identifier);
 
 private:
 	static NetworkManagerFactory *m_instance;
@@ -232,6 +257,8 @@ private:
 	static QString m_acceptLanguage;
 	static QMap<QString, ProxyDefinition> m_proxies;
 	static QMap<QString, UserAgentDefinition> m_userAgents;
+	static QHash<QString, NetworkPolicy> m_networkPolicies;
+	static QVector<int> m_networkPolicyOptions;
 	static QList<QSslCipher> m_defaultCiphers;
 	static DoNotTrackPolicy m_doNotTrackPolicy;
 	static bool m_canSendReferrer;
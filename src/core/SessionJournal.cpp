@@ -0,0 +1,552 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "SessionJournal.h"
+#include "Console.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+const quint32 SessionJournal::JournalMagic(0x4F534A4C);
+const quint32 SessionJournal::JournalVersion(1);
+
+SessionJournal::SessionJournal(const QString &path) :
+	m_path(path),
+	m_size(0),
+	m_recordsAmount(0),
+	m_isValid(false)
+{
+}
+
+void SessionJournal::clear()
+{
+	m_pendingRecords.clear();
+	m_mainWindows.clear();
+	m_windows.clear();
+
+	m_size = 0;
+	m_recordsAmount = 0;
+	m_isValid = false;
+
+	if (QFile::exists(m_path))
+	{
+		QFile::remove(m_path);
+	}
+}
+
+void SessionJournal::reset(const SessionInformation &session, const QVector<Layout> &layouts)
+{
+	m_pendingRecords.clear();
+	m_mainWindows.clear();
+	m_windows.clear();
+
+	for (int i = 0; i < layouts.count(); ++i)
+	{
+		const Session::MainWindow &mainWindow(session.windows.at(i));
+		MainWindowState mainWindowState;
+		mainWindowState.geometry = mainWindow.geometry;
+		mainWindowState.windows = layouts.at(i).windows;
+		mainWindowState.index = mainWindow.index;
+
+		m_mainWindows[layouts.at(i).identifier] = mainWindowState;
+
+		for (int j = 0; j < layouts.at(i).windows.count(); ++j)
+		{
+			WindowState windowState;
+			windowState.checksum = QCryptographicHash::hash(createWindowData(mainWindow.windows.at(j)), QCryptographicHash::Sha1);
+			windowState.isPinned = mainWindow.windows.at(j).isPinned;
+
+			m_windows[layouts.at(i).windows.at(j)] = windowState;
+		}
+	}
+
+	m_size = 0;
+	m_recordsAmount = 0;
+	m_isValid = true;
+}
+
+void SessionJournal::setMainWindow(const Layout &layout, const QByteArray &geometry, int index)
+{
+	if (m_mainWindows.contains(layout.identifier))
+	{
+		const MainWindowState &state(m_mainWindows[layout.identifier]);
+
+		if (state.index == index && state.windows == layout.windows && state.geometry == geometry)
+		{
+			return;
+		}
+	}
+
+	MainWindowState state;
+	state.geometry = geometry;
+	state.windows = layout.windows;
+	state.index = index;
+
+	m_mainWindows[layout.identifier] = state;
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << static_cast<quint8>(MainWindowRecord) << layout.identifier << geometry << static_cast<qint32>(index) << layout.windows;
+
+	++m_recordsAmount;
+}
+
+void SessionJournal::setWindow(quint64 identifier, const Session::Window &session)
+{
+	const QByteArray data(createWindowData(session));
+	const QByteArray checksum(QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+
+	if (m_windows.value(identifier).checksum == checksum)
+	{
+		return;
+	}
+
+	WindowState state;
+	state.checksum = checksum;
+	state.isPinned = session.isPinned;
+
+	m_windows[identifier] = state;
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << static_cast<quint8>(WindowRecord) << identifier;
+	stream.writeRawData(data.constData(), data.size());
+
+	++m_recordsAmount;
+}
+
+void SessionJournal::setWindowPinned(quint64 identifier, bool isPinned)
+{
+	if (!m_windows.contains(identifier) || m_windows[identifier].isPinned == isPinned)
+	{
+		return;
+	}
+
+	m_windows[identifier].isPinned = isPinned;
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << static_cast<quint8>(PinRecord) << identifier << isPinned;
+
+	++m_recordsAmount;
+}
+
+void SessionJournal::removeWindows(const QSet<quint64> &mainWindows, const QSet<quint64> &windows)
+{
+	QHash<quint64, MainWindowState>::iterator mainWindowsIterator(m_mainWindows.begin());
+
+	while (mainWindowsIterator != m_mainWindows.end())
+	{
+		if (mainWindows.contains(mainWindowsIterator.key()))
+		{
+			++mainWindowsIterator;
+		}
+		else
+		{
+			mainWindowsIterator = m_mainWindows.erase(mainWindowsIterator);
+		}
+	}
+
+	QDataStream stream(&m_pendingRecords, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	QHash<quint64, WindowState>::iterator windowsIterator(m_windows.begin());
+
+	while (windowsIterator != m_windows.end())
+	{
+		if (windows.contains(windowsIterator.key()))
+		{
+			++windowsIterator;
+		}
+		else
+		{
+			stream << static_cast<quint8>(CloseRecord) << windowsIterator.key();
+
+			++m_recordsAmount;
+
+			windowsIterator = m_windows.erase(windowsIterator);
+		}
+	}
+}
+
+void SessionJournal::writeWindow(QDataStream &stream, const Session::Window &session)
+{
+	stream << session.identity << session.state.geometry << static_cast<qint32>(session.state.state) << session.isAlwaysOnTop << session.isPinned << static_cast<qint32>(session.history.index) << static_cast<quint32>(session.history.entries.count());
+
+	for (int i = 0; i < session.history.entries.count(); ++i)
+	{
+		const Session::Window::History::Entry &entry(session.history.entries.at(i));
+
+		stream << entry.url << entry.title << entry.time << entry.position << static_cast<qint32>(entry.zoom);
+	}
+
+	QList<int> options(session.options.keys());
+
+	std::sort(options.begin(), options.end());
+
+	stream << static_cast<quint32>(options.count());
+
+	for (int i = 0; i < options.count(); ++i)
+	{
+		stream << static_cast<qint32>(options.at(i)) << session.options.value(options.at(i));
+	}
+}
+
+Session::Window SessionJournal::readWindow(QDataStream &stream)
+{
+	Session::Window session;
+	qint32 state(Qt::WindowNoState);
+	qint32 index(-1);
+	quint32 entriesAmount(0);
+
+	stream >> session.identity >> session.state.geometry >> state >> session.isAlwaysOnTop >> session.isPinned >> index >> entriesAmount;
+
+	session.state.state = static_cast<Qt::WindowState>(state);
+	session.history.index = index;
+
+	for (quint32 i = 0; i < entriesAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		Session::Window::History::Entry entry;
+		qint32 zoom(0);
+
+		stream >> entry.url >> entry.title >> entry.time >> entry.position >> zoom;
+
+		entry.zoom = zoom;
+
+		session.history.entries.append(entry);
+	}
+
+	quint32 optionsAmount(0);
+
+	stream >> optionsAmount;
+
+	for (quint32 i = 0; i < optionsAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		qint32 identifier(-1);
+		QVariant value;
+
+		stream >> identifier >> value;
+
+		session.options[identifier] = value;
+	}
+
+	if (session.history.index < 0 || session.history.index >= session.history.entries.count())
+	{
+		session.history.index = (session.history.entries.count() - 1);
+	}
+
+	return session;
+}
+
+QByteArray SessionJournal::createWindowData(const Session::Window &session)
+{
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	writeWindow(stream, session);
+
+	return data;
+}
+
+QByteArray SessionJournal::createSnapshotChecksum(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+
+	return hash.result();
+}
+
+bool SessionJournal::create(const QString &path, const QString &snapshotPath, const QVector<Layout> &layouts)
+{
+	const QByteArray checksum(createSnapshotChecksum(snapshotPath));
+
+	if (checksum.isEmpty())
+	{
+		return false;
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << JournalMagic << JournalVersion << static_cast<quint8>(SnapshotRecord) << checksum << static_cast<quint32>(layouts.count());
+
+	for (int i = 0; i < layouts.count(); ++i)
+	{
+		stream << layouts.at(i).identifier << layouts.at(i).windows;
+	}
+
+	return file.commit();
+}
+
+bool SessionJournal::replay(const QString &path, const QString &snapshotPath, SessionInformation *session)
+{
+	QFile file(path);
+
+	if (!file.exists() || !file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+
+	quint32 magic(0);
+	quint32 version(0);
+	quint8 type(UnknownRecord);
+	QByteArray checksum;
+	quint32 mainWindowsAmount(0);
+
+	stream >> magic >> version >> type >> checksum >> mainWindowsAmount;
+
+	if (stream.status() != QDataStream::Ok || magic != JournalMagic || version != JournalVersion || type != SnapshotRecord || mainWindowsAmount != static_cast<quint32>(session->windows.count()) || checksum != createSnapshotChecksum(snapshotPath))
+	{
+		return false;
+	}
+
+	QVector<quint64> mainWindowsOrder;
+	QHash<quint64, Session::MainWindow> mainWindows;
+	QHash<quint64, QVector<quint64> > layouts;
+	QHash<quint64, Session::Window> windows;
+
+	for (int i = 0; i < session->windows.count(); ++i)
+	{
+		quint64 identifier(0);
+		QVector<quint64> identifiers;
+
+		stream >> identifier >> identifiers;
+
+		Session::MainWindow mainWindow(session->windows.at(i));
+
+		if (stream.status() != QDataStream::Ok || identifiers.count() != mainWindow.windows.count())
+		{
+			return false;
+		}
+
+		for (int j = 0; j < identifiers.count(); ++j)
+		{
+			windows[identifiers.at(j)] = mainWindow.windows.at(j);
+		}
+
+		mainWindow.windows.clear();
+
+		mainWindowsOrder.append(identifier);
+		mainWindows[identifier] = mainWindow;
+		layouts[identifier] = identifiers;
+	}
+
+	int recordsAmount(0);
+
+	while (!stream.atEnd())
+	{
+		stream >> type;
+
+		switch (type)
+		{
+			case MainWindowRecord:
+				{
+					quint64 identifier(0);
+					QByteArray geometry;
+					qint32 index(-1);
+					QVector<quint64> identifiers;
+
+					stream >> identifier >> geometry >> index >> identifiers;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						if (!mainWindows.contains(identifier))
+						{
+							mainWindowsOrder.append(identifier);
+						}
+
+						mainWindows[identifier].geometry = geometry;
+						mainWindows[identifier].index = index;
+
+						layouts[identifier] = identifiers;
+					}
+				}
+
+				break;
+			case WindowRecord:
+				{
+					quint64 identifier(0);
+
+					stream >> identifier;
+
+					const Session::Window window(readWindow(stream));
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						windows[identifier] = window;
+					}
+				}
+
+				break;
+			case PinRecord:
+				{
+					quint64 identifier(0);
+					bool isPinned(false);
+
+					stream >> identifier >> isPinned;
+
+					if (stream.status() == QDataStream::Ok && windows.contains(identifier))
+					{
+						windows[identifier].isPinned = isPinned;
+					}
+				}
+
+				break;
+			case CloseRecord:
+				{
+					quint64 identifier(0);
+
+					stream >> identifier;
+
+					if (stream.status() == QDataStream::Ok)
+					{
+						windows.remove(identifier);
+					}
+				}
+
+				break;
+			default:
+				stream.setStatus(QDataStream::ReadCorruptData);
+
+				break;
+		}
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Session journal ends with incomplete record"), Console::OtherCategory, Console::WarningLevel, path);
+
+			break;
+		}
+
+		++recordsAmount;
+	}
+
+	if (recordsAmount == 0)
+	{
+		return false;
+	}
+
+	session->windows.clear();
+
+	for (int i = 0; i < mainWindowsOrder.count(); ++i)
+	{
+		const QVector<quint64> identifiers(layouts.value(mainWindowsOrder.at(i)));
+		Session::MainWindow mainWindow(mainWindows.value(mainWindowsOrder.at(i)));
+		int index(-1);
+
+		for (int j = 0; j < identifiers.count(); ++j)
+		{
+			if (windows.contains(identifiers.at(j)))
+			{
+				if (j == mainWindow.index)
+				{
+					index = mainWindow.windows.count();
+				}
+
+				mainWindow.windows.append(windows.value(identifiers.at(j)));
+			}
+		}
+
+		if (mainWindow.windows.isEmpty())
+		{
+			continue;
+		}
+
+		mainWindow.index = ((index >= 0) ? index : (mainWindow.windows.count() - 1));
+
+		session->windows.append(mainWindow);
+	}
+
+	return true;
+}
+
+bool SessionJournal::hasWindow(quint64 identifier) const
+{
+	return m_windows.contains(identifier);
+}
+
+bool SessionJournal::isValid() const
+{
+	return m_isValid;
+}
+
+bool SessionJournal::needsCompaction() const
+{
+	return (m_recordsAmount > 1000 || m_size > 4194304);
+}
+
+bool SessionJournal::flush()
+{
+	if (!m_isValid)
+	{
+		return false;
+	}
+
+	if (m_pendingRecords.isEmpty())
+	{
+		return true;
+	}
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save session journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		m_isValid = false;
+
+		return false;
+	}
+
+	if (file.write(m_pendingRecords) != m_pendingRecords.size())
+	{
+		m_isValid = false;
+
+		return false;
+	}
+
+	m_size += m_pendingRecords.size();
+
+	m_pendingRecords.clear();
+
+	return true;
+}
+
+}
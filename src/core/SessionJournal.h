@@ -0,0 +1,99 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SESSIONJOURNAL_H
+#define OTTER_SESSIONJOURNAL_H
+
+#include "SessionsManager.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QSet>
+
+namespace Otter
+{
+
+class SessionJournal final
+{
+public:
+	struct Layout final
+	{
+		quint64 identifier = 0;
+		QVector<quint64> windows;
+	};
+
+	explicit SessionJournal(const QString &path);
+
+	void clear();
+	void reset(const SessionInformation &session, const QVector<Layout> &layouts);
+	void setMainWindow(const Layout &layout, const QByteArray &geometry, int index);
+	void setWindow(quint64 identifier, const Session::Window &session);
+	void setWindowPinned(quint64 identifier, bool isPinned);
+	void removeWindows(const QSet<quint64> &mainWindows, const QSet<quint64> &windows);
+	static bool create(const QString &path, const QString &snapshotPath, const QVector<Layout> &layouts);
+	static bool replay(const QString &path, const QString &snapshotPath, SessionInformation *session);
+	bool hasWindow(quint64 identifier) const;
+	bool isValid() const;
+	bool needsCompaction() const;
+	bool flush();
+
+protected:
+	enum RecordType
+	{
+		UnknownRecord = 0,
+		SnapshotRecord,
+		MainWindowRecord,
+		WindowRecord,
+		PinRecord,
+		CloseRecord
+	};
+
+	struct MainWindowState final
+	{
+		QByteArray geometry;
+		QVector<quint64> windows;
+		int index = -1;
+	};
+
+	struct WindowState final
+	{
+		QByteArray checksum;
+		bool isPinned = false;
+	};
+
+	static void writeWindow(QDataStream &stream, const Session::Window &session);
+	static Session::Window readWindow(QDataStream &stream);
+	static QByteArray createWindowData(const Session::Window &session);
+	static QByteArray createSnapshotChecksum(const QString &path);
+
+private:
+	QString m_path;
+	QByteArray m_pendingRecords;
+	QHash<quint64, MainWindowState> m_mainWindows;
+	QHash<quint64, WindowState> m_windows;
+	qint64 m_size;
+	int m_recordsAmount;
+	bool m_isValid;
+
+	static const quint32 JournalMagic;
+	static const quint32 JournalVersion;
+};
+
+}
+
+#endif
@@ -21,10 +21,12 @@
 #include "SessionsManager.h"
 #include "Application.h"
 #include "JsonSettings.h"
+#include "SessionJournal.h"
 #include "SessionModel.h"
 #include "../ui/MainWindow.h"
 #include "../ui/Window.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
@@ -38,18 +40,24 @@ Session::Session(QObject *parent) : QObject(parent)
 
 SessionsManager* SessionsManager::m_instance(nullptr);
 SessionModel* SessionsManager::m_model(nullptr);
+SessionJournal* SessionsManager::m_journal(nullptr);
 QString SessionsManager::m_sessionPath;
 QString SessionsManager::m_sessionTitle;
+QString SessionsManager::m_preloadedSessionPath;
 QString SessionsManager::m_cachePath;
 QString SessionsManager::m_profilePath;
 QHash<QString, Session::Identity> SessionsManager::m_identities;
 QVector<Session::MainWindow> SessionsManager::m_closedWindows;
+QFuture<JsonSettings> SessionsManager::m_preloadedSession;
+QSet<quint64> SessionsManager::m_modifiedWindows;
 int SessionsManager::m_openHintEnumerator(0);
 bool SessionsManager::m_isDirty(false);
 bool SessionsManager::m_isPrivate(false);
 bool SessionsManager::m_isReadOnly(false);
 
 SessionsManager::SessionsManager(QObject *parent) : QObject(parent),
+	m_compactionWatcher(nullptr),
+	m_compactionTime(0),
 	m_saveTimer(0)
 {
 }
@@ -66,7 +74,7 @@ void SessionsManager::timerEvent(QTimerEvent *event)
 
 		if (!m_isPrivate)
 		{
-			saveSession({}, {}, nullptr, false);
+			updateSession();
 		}
 	}
 }
@@ -92,6 +100,171 @@ void SessionsManager::scheduleSave()
 	}
 }
 
+void SessionsManager::updateSession()
+{
+	if (!m_journal)
+	{
+		m_journal = new SessionJournal(getJournalPath());
+	}
+
+	if (!m_journal->isValid())
+	{
+		compactSession();
+
+		return;
+	}
+
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QSet<quint64> mainWindowIdentifiers;
+	QSet<quint64> windowIdentifiers;
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		MainWindow *mainWindow(mainWindows.at(i));
+
+		if (mainWindow->isPrivate())
+		{
+			continue;
+		}
+
+		SessionJournal::Layout layout;
+		layout.identifier = mainWindow->getIdentifier();
+		layout.windows.reserve(mainWindow->getWindowCount());
+
+		int index(mainWindow->getCurrentWindowIndex());
+
+		for (int j = 0; j < mainWindow->getWindowCount(); ++j)
+		{
+			const Window *window(mainWindow->getWindowByIndex(j));
+
+			if (!window || window->isPrivate())
+			{
+				if (j <= index)
+				{
+					--index;
+				}
+
+				continue;
+			}
+
+			const quint64 identifier(window->getIdentifier());
+
+			if (!m_journal->hasWindow(identifier) || m_modifiedWindows.contains(identifier))
+			{
+				m_journal->setWindow(identifier, window->getSession());
+			}
+			else
+			{
+				m_journal->setWindowPinned(identifier, window->isPinned());
+			}
+
+			layout.windows.append(identifier);
+
+			windowIdentifiers.insert(identifier);
+		}
+
+		m_journal->setMainWindow(layout, mainWindow->saveGeometry(), index);
+
+		mainWindowIdentifiers.insert(layout.identifier);
+	}
+
+	m_journal->removeWindows(mainWindowIdentifiers, windowIdentifiers);
+
+	m_modifiedWindows.clear();
+
+	if (!m_compactionWatcher && (m_journal->needsCompaction() || (QDateTime::currentMSecsSinceEpoch() - m_compactionTime) > 300000))
+	{
+		compactSession();
+	}
+	else if (!m_compactionWatcher)
+	{
+		m_journal->flush();
+	}
+}
+
+void SessionsManager::compactSession()
+{
+	if (m_compactionWatcher)
+	{
+		scheduleSave();
+
+		return;
+	}
+
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QVector<SessionJournal::Layout> layouts;
+	SessionInformation session;
+	session.path = getSessionPath({});
+	session.title = m_sessionTitle;
+	session.isClean = false;
+	session.windows.reserve(mainWindows.count());
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		const MainWindow *mainWindow(mainWindows.at(i));
+
+		if (mainWindow->isPrivate())
+		{
+			continue;
+		}
+
+		SessionJournal::Layout layout;
+		layout.identifier = mainWindow->getIdentifier();
+
+		for (int j = 0; j < mainWindow->getWindowCount(); ++j)
+		{
+			const Window *window(mainWindow->getWindowByIndex(j));
+
+			if (window && !window->isPrivate())
+			{
+				layout.windows.append(window->getIdentifier());
+			}
+		}
+
+		session.windows.append(mainWindow->getSession());
+
+		layouts.append(layout);
+	}
+
+	m_modifiedWindows.clear();
+
+	if (session.windows.isEmpty())
+	{
+		return;
+	}
+
+	m_journal->reset(session, layouts);
+
+	m_compactionTime = QDateTime::currentMSecsSinceEpoch();
+	m_compactionWatcher = new QFutureWatcher<bool>(this);
+
+	connect(m_compactionWatcher, &QFutureWatcher<bool>::finished, this, [&]()
+	{
+		const bool isSuccess(m_compactionWatcher->result());
+
+		m_compactionWatcher->deleteLater();
+		m_compactionWatcher = nullptr;
+
+		if (isSuccess)
+		{
+			m_journal->flush();
+		}
+		else
+		{
+			m_journal->clear();
+		}
+	});
+
+	const QString journalPath(getJournalPath());
+	const QHash<int, QString> toolBarNames(getToolBarNames(session));
+	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
+
+	m_compactionWatcher->setFuture(QtConcurrent::run([=]()
+	{
+		return (writeSession(session, toolBarNames, excludedOptions) && SessionJournal::create(journalPath, session.path, layouts));
+	}));
+}
+
 void SessionsManager::clearClosedWindows()
 {
 	m_closedWindows.clear();
@@ -126,8 +299,13 @@ void SessionsManager::storeClosedWindow(MainWindow *mainWindow)
 	emit m_instance->closedWindowsChanged();
 }
 
-void SessionsManager::markSessionAsModified()
+void SessionsManager::markSessionAsModified(quint64 windowIdentifier)
 {
+	if (windowIdentifier > 0 && !m_isPrivate)
+	{
+		m_modifiedWindows.insert(windowIdentifier);
+	}
+
 	if (!m_isPrivate && !m_isDirty && m_sessionPath == QLatin1String("default"))
 	{
 		m_isDirty = true;
@@ -136,6 +314,15 @@ void SessionsManager::markSessionAsModified()
 	}
 }
 
+void SessionsManager::preloadSession(const QString &path)
+{
+	m_preloadedSessionPath = path;
+	m_preloadedSession = QtConcurrent::run([=]()
+	{
+		return JsonSettings(getSessionPath(path));
+	});
+}
+
 void SessionsManager::removeStoredUrl(const QString &url)
 {
 	emit m_instance->requestedRemoveStoredUrl(url);
@@ -183,6 +370,31 @@ QString SessionsManager::getWritableDataPath(const QString &path)
 	return QDir::toNativeSeparators(m_profilePath + QDir::separator() + path);
 }
 
+QString SessionsManager::getJournalPath()
+{
+	return QDir::toNativeSeparators(m_profilePath + QLatin1String("/sessions/default.journal"));
+}
+
+QHash<int, QString> SessionsManager::getToolBarNames(const SessionInformation &session)
+{
+	QHash<int, QString> names;
+
+	for (int i = 0; i < session.windows.count(); ++i)
+	{
+		const QVector<Session::MainWindow::ToolBarState> toolBars(session.windows.at(i).toolBars);
+
+		for (int j = 0; j < toolBars.count(); ++j)
+		{
+			if (!names.contains(toolBars.at(j).identifier))
+			{
+				names[toolBars.at(j).identifier] = ToolBarsManager::getToolBarName(toolBars.at(j).identifier);
+			}
+		}
+	}
+
+	return names;
+}
+
 QString SessionsManager::getSessionPath(const QString &path, bool isBound)
 {
 	QString normalizedPath(path);
@@ -219,7 +431,19 @@ Session::Identity SessionsManager::getIdentity(const QString &name)
 SessionInformation SessionsManager::getSession(const QString &path)
 {
 	SessionInformation session;
-	const JsonSettings settings(getSessionPath(path));
+	JsonSettings settings;
+
+	if (!m_preloadedSessionPath.isEmpty() && m_preloadedSessionPath == path)
+	{
+		settings = m_preloadedSession.result();
+
+		m_preloadedSessionPath.clear();
+		m_preloadedSession = QFuture<JsonSettings>();
+	}
+	else
+	{
+		settings = JsonSettings(getSessionPath(path));
+	}
 
 	if (settings.isNull())
 	{
@@ -403,6 +627,11 @@ SessionInformation SessionsManager::getSession(const QString &path)
 		session.windows.append(sessionMainWindow);
 	}
 
+	if (path == QLatin1String("default") && !m_isPrivate)
+	{
+		SessionJournal::replay(getJournalPath(), getSessionPath(path), &session);
+	}
+
 	if (session.index < 0 || session.index >= session.windows.count())
 	{
 		session.index = (session.windows.count() - 1);
@@ -613,10 +842,30 @@ bool SessionsManager::saveSession(const QString &path, const QString &title, Mai
 
 	session.windows.squeeze();
 
-	return saveSession(session);
+	if (m_instance->m_compactionWatcher)
+	{
+		m_instance->m_compactionWatcher->waitForFinished();
+	}
+
+	if (!saveSession(session))
+	{
+		return false;
+	}
+
+	if (m_journal && session.path == getSessionPath({}))
+	{
+		m_journal->clear();
+	}
+
+	return true;
 }
 
 bool SessionsManager::saveSession(const SessionInformation &session)
+{
+	return writeSession(session, getToolBarNames(session), SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
+}
+
+bool SessionsManager::writeSession(const SessionInformation &session, const QHash<int, QString> &toolBarNames, const QStringList &excludedOptions)
 {
 	const QString sessionsPath(m_profilePath + QLatin1String("/sessions/"));
 
@@ -647,7 +896,6 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 		}
 	}
 
-	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
 	QJsonArray mainWindowsArray;
 	QJsonObject sessionObject({{QLatin1String("title"), session.title}, {QLatin1String("currentIndex"), 1}});
 
@@ -754,7 +1002,7 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 
 			for (int j = 0; j < sessionEntry.toolBars.count(); ++j)
 			{
-				const QString identifier(ToolBarsManager::getToolBarName(sessionEntry.toolBars.at(j).identifier));
+				const QString identifier(toolBarNames.value(sessionEntry.toolBars.at(j).identifier));
 
 				if (identifier.isEmpty())
 				{
@@ -21,18 +21,22 @@
 #ifndef OTTER_SESSIONSMANAGER_H
 #define OTTER_SESSIONSMANAGER_H
 
+#include "JsonSettings.h"
 #include "SettingsManager.h"
 #include "ToolBarsManager.h"
 #include "Utils.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QRect>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
 class MainWindow;
+class SessionJournal;
 class SessionModel;
 
 class Session final : public QObject
@@ -243,7 +247,8 @@ public:
 	static void createInstance(const QString &profilePath, const QString &cachePath, bool isPrivate = false, bool isReadOnly = false);
 	static void clearClosedWindows();
 	static void storeClosedWindow(MainWindow *mainWindow);
-	static void markSessionAsModified();
+	static void markSessionAsModified(quint64 windowIdentifier = 0);
+	static void preloadSession(const QString &path);
 	static void removeStoredUrl(const QString &url);
 	static SessionsManager* getInstance();
 	static SessionModel* getModel();
@@ -275,18 +280,29 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	void updateSession();
+	void compactSession();
+	static QString getJournalPath();
+	static QHash<int, QString> getToolBarNames(const SessionInformation &session);
+	static bool writeSession(const SessionInformation &session, const QHash<int, QString> &toolBarNames, const QStringList &excludedOptions);
 
 private:
+	QFutureWatcher<bool> *m_compactionWatcher;
+	qint64 m_compactionTime;
 	int m_saveTimer;
 
 	static SessionsManager *m_instance;
 	static SessionModel *m_model;
+	static SessionJournal *m_journal;
 	static QString m_sessionPath;
 	static QString m_sessionTitle;
+	static QString m_preloadedSessionPath;
 	static QString m_cachePath;
 	static QString m_profilePath;
 	static QHash<QString, Session::Identity> m_identities;
 	static QVector<Session::MainWindow> m_closedWindows;
+	static QFuture<JsonSettings> m_preloadedSession;
+	static QSet<quint64> m_modifiedWindows;
 	static int m_openHintEnumerator;
 	static bool m_isDirty;
 	static bool m_isPrivate;
@@ -34,15 +34,45 @@ SettingsManager* SettingsManager::m_instance(nullptr);
 QString SettingsManager::m_globalPath;
 QString SettingsManager::m_overridePath;
 QVector<SettingsManager::OptionDefinition> SettingsManager::m_definitions;
+QVector<QVariant> SettingsManager::m_values;
+QVector<SettingsManager::PendingChange> SettingsManager::m_pendingChanges;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_overrides;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_wildcardedOverrides;
 QHash<QString, int> SettingsManager::m_customOptions;
+QReadWriteLock SettingsManager::m_lock;
 int SettingsManager::m_identifierCounter(-1);
 int SettingsManager::m_optionIdentifierEnumerator(0);
-bool SettingsManager::m_hasWildcardedOverrides(false);
 
-SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
+SettingsManager::SettingsManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
 {
 }
 
+SettingsManager::~SettingsManager()
+{
+	savePendingChanges();
+}
+
+void SettingsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		savePendingChanges();
+	}
+}
+
+void SettingsManager::scheduleSave()
+{
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(1000);
+	}
+}
+
 void SettingsManager::createInstance(const QString &path)
 {
 	if (m_instance)
@@ -69,6 +99,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(AddressField_ShowSuggestionsOnFocusOption, BooleanType, true);
 	registerOption(AddressField_SuggestBookmarksOption, BooleanType, true);
 	registerOption(AddressField_SuggestHistoryOption, BooleanType, true);
+	registerOption(AddressField_SuggestHistoryLimitOption, IntegerType, 10);
 	registerOption(AddressField_SuggestLocalPathsOption, BooleanType, true);
 	registerOption(AddressField_SuggestSearchOption, BooleanType, true);
 	registerOption(AddressField_SuggestSpecialPagesOption, BooleanType, true);
@@ -97,6 +128,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Browser_SpellCheckDictionaryOption, StringType, QString());
 	registerOption(Browser_SpellCheckIgnoreDctionariesOption, StringType, QStringList());
 	registerOption(Browser_StartupBehaviorOption, EnumerationType, QLatin1String("continuePrevious"), {QLatin1String("continuePrevious"), QLatin1String("showDialog"), QLatin1String("startHomePage"), QLatin1String("startStartPage"), QLatin1String("startEmpty")});
+	registerOption(Browser_TabsMemoryLimitOption, IntegerType, 0);
 	registerOption(Browser_TransferStartingActionOption, EnumerationType, QLatin1String("doNothing"), {QLatin1String("openTab"), QLatin1String("openBackgroundTab"), QLatin1String("openPanel"), QLatin1String("doNothing")});
 	registerOption(Browser_ValidatorsOrderOption, ListType, QStringList({QLatin1String("w3c-markup"), QLatin1String("w3c-css")}));
 	registerOption(Cache_DiskCacheLimitOption, IntegerType, 51200);
@@ -127,7 +159,10 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Content_ZoomTextOnlyOption, BooleanType, false);
 	registerOption(ContentBlocking_EnableContentBlockingOption, BooleanType, true);
 	registerOption(ContentBlocking_IgnoreHostsOption, ListType, QStringList());
+	registerOption(ContentBlocking_MatcherModeOption, EnumerationType, QLatin1String("index"), {QLatin1String("index"), QLatin1String("trie"), QLatin1String("compare")});
+	registerOption(ContentBlocking_MergeProfilesOption, BooleanType, false);
 	registerOption(ContentBlocking_ProfilesOption, ListType, QStringList());
+	registerOption(History_BrowsingDownsamplePeriodOption, IntegerType, 90);
 	registerOption(History_BrowsingLimitAmountGlobalOption, IntegerType, 1000);
 	registerOption(History_BrowsingLimitAmountWindowOption, IntegerType, 50);
 	registerOption(History_BrowsingLimitPeriodOption, IntegerType, 30);
@@ -245,71 +280,102 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Updates_LastCheckOption, StringType, QString());
 	registerOption(Updates_ServerUrlOption, StringType, QLatin1String("https://www.otter-browser.org/updates/update.json"));
 
-	const QStringList hosts(getOverrideHosts());
+	loadOptions();
+}
+
+void SettingsManager::loadOptions(int identifier)
+{
+	const QSettings settings(m_globalPath, QSettings::IniFormat);
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrides.childGroups());
+	const QString name((identifier < 0) ? QString() : getOptionName(identifier));
+	QWriteLocker locker(&m_lock);
+
+	m_values.resize(m_definitions.count());
+
+	if (identifier < 0)
+	{
+		for (int i = 0; i < m_definitions.count(); ++i)
+		{
+			m_values[i] = normalizeValue(i, settings.value(getOptionName(i)));
+		}
+	}
+	else
+	{
+		m_values[identifier] = normalizeValue(identifier, settings.value(name));
+	}
 
 	for (int i = 0; i < hosts.count(); ++i)
 	{
-		if (hosts.at(i).startsWith(QLatin1Char('*')))
+		overrides.beginGroup(hosts.at(i));
+
+		if (identifier < 0)
 		{
-			m_hasWildcardedOverrides = true;
+			const QStringList keys(overrides.allKeys());
 
-			break;
+			for (int j = 0; j < keys.count(); ++j)
+			{
+				const int option(getOptionIdentifier(keys.at(j)));
+
+				if (option >= 0)
+				{
+					setOverrideValue(hosts.at(i), option, normalizeValue(option, overrides.value(keys.at(j))));
+				}
+			}
+		}
+		else if (overrides.contains(name))
+		{
+			setOverrideValue(hosts.at(i), identifier, normalizeValue(identifier, overrides.value(name)));
 		}
+
+		overrides.endGroup();
 	}
 }
 
 void SettingsManager::removeOverride(const QString &host, int identifier)
 {
-	QSettings settings(m_overridePath, QSettings::IniFormat);
-
 	if (identifier >= 0)
 	{
-		settings.remove(host + QLatin1Char('/') + getOptionName(identifier));
-		settings.sync();
-
-		emit m_instance->hostOptionChanged(identifier, getOption(identifier), host);
+		{
+			QWriteLocker locker(&m_lock);
 
-		return;
-	}
+			setOverrideValue(host, identifier, {});
+		}
 
-	settings.beginGroup(host);
+		addPendingChange(host + QLatin1Char('/') + getOptionName(identifier), {}, getOptionDefinition(identifier).type, true);
 
-	const QStringList groups(settings.childGroups());
+		emit m_instance->hostOptionChanged(identifier, getOption(identifier), host);
 
-	if (groups.isEmpty())
-	{
 		return;
 	}
 
 	QVector<int> options;
-	options.reserve(groups.count());
 
-	for (int i = 0; i < groups.count(); ++i)
 	{
-		settings.beginGroup(groups.at(i));
+		QWriteLocker locker(&m_lock);
 
-		const QStringList rawOptions(settings.childKeys());
+		const QList<int> overridenOptions(m_overrides.value(host).keys());
 
-		for (int j = 0; j < rawOptions.count(); ++j)
-		{
-			const int option(getOptionIdentifier(groups.at(i) + QLatin1Char('/') + rawOptions.at(j)));
+		options = overridenOptions.toVector();
 
-			if (option >= 0)
-			{
-				options.append(option);
-			}
+		m_overrides.remove(host);
+
+		if (host.startsWith(QLatin1String("*.")))
+		{
+			m_wildcardedOverrides.remove(host.mid(2));
 		}
+	}
 
-		settings.endGroup();
+	if (options.isEmpty())
+	{
+		return;
 	}
 
-	settings.endGroup();
-	settings.remove(host);
-	settings.sync();
+	addPendingChange(host, {}, UnknownType, true);
 
 	for (int i = 0; i < options.count(); ++i)
 	{
-		emit m_instance->hostOptionChanged(identifier, getOption(options.at(i)), host);
+		emit m_instance->hostOptionChanged(options.at(i), getOption(options.at(i)), host);
 	}
 }
 
@@ -325,23 +391,95 @@ void SettingsManager::registerOption(int identifier, OptionType type, const QVar
 	m_definitions.append(definition);
 }
 
-void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type)
+void SettingsManager::addPendingChange(const QString &key, const QVariant &value, OptionType type, bool isOverride)
 {
-	QSettings settings(path, QSettings::IniFormat);
+	PendingChange change;
+	change.key = key;
+	change.value = value;
+	change.type = type;
+	change.isOverride = isOverride;
+
+	m_pendingChanges.append(change);
+
+	m_instance->scheduleSave();
+}
 
+void SettingsManager::saveOption(QSettings *settings, const QString &key, const QVariant &value, OptionType type)
+{
 	if (value.isNull())
 	{
-		settings.remove(key);
+		settings->remove(key);
 	}
 	else if (type == ColorType)
 	{
 		const QColor color(value.value<QColor>());
 
-		settings.setValue(key, (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString()));
+		settings->setValue(key, (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString()));
 	}
 	else
 	{
-		settings.setValue(key, value);
+		settings->setValue(key, value);
+	}
+}
+
+void SettingsManager::savePendingChanges()
+{
+	if (m_pendingChanges.isEmpty())
+	{
+		return;
+	}
+
+	QSettings settings(m_globalPath, QSettings::IniFormat);
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+
+	for (int i = 0; i < m_pendingChanges.count(); ++i)
+	{
+		const PendingChange &change(m_pendingChanges.at(i));
+
+		saveOption((change.isOverride ? &overrides : &settings), change.key, change.value, change.type);
+	}
+
+	m_pendingChanges.clear();
+
+	settings.sync();
+	overrides.sync();
+}
+
+void SettingsManager::setOverrideValue(const QString &host, int identifier, const QVariant &value)
+{
+	const bool isWildcarded(host.startsWith(QLatin1String("*.")));
+
+	if (value.isNull())
+	{
+		if (m_overrides.contains(host))
+		{
+			m_overrides[host].remove(identifier);
+
+			if (m_overrides[host].isEmpty())
+			{
+				m_overrides.remove(host);
+			}
+		}
+
+		if (isWildcarded && m_wildcardedOverrides.contains(host.mid(2)))
+		{
+			QHash<int, QVariant> &wildcardedOverrides(m_wildcardedOverrides[host.mid(2)]);
+			wildcardedOverrides.remove(identifier);
+
+			if (wildcardedOverrides.isEmpty())
+			{
+				m_wildcardedOverrides.remove(host.mid(2));
+			}
+		}
+
+		return;
+	}
+
+	m_overrides[host][identifier] = value;
+
+	if (isWildcarded)
+	{
+		m_wildcardedOverrides[host.mid(2)][identifier] = value;
 	}
 }
 
@@ -349,6 +487,8 @@ void SettingsManager::updateOptionDefinition(int identifier, const SettingsManag
 {
 	if (identifier >= 0 && identifier < m_definitions.count())
 	{
+		QWriteLocker locker(&m_lock);
+
 		m_definitions[identifier].defaultValue = definition.defaultValue;
 		m_definitions[identifier].choices = definition.choices;
 	}
@@ -356,27 +496,24 @@ void SettingsManager::updateOptionDefinition(int identifier, const SettingsManag
 
 void SettingsManager::setOption(int identifier, const QVariant &value, const QString &host)
 {
+	if (identifier < 0 || identifier >= m_definitions.count())
+	{
+		return;
+	}
+
 	const QString name(getOptionName(identifier));
 	const OptionType type(getOptionDefinition(identifier).type);
 
 	if (!host.isEmpty())
 	{
-		const QString overrideName(host + QLatin1Char('/') + name);
-
-		if (value.isNull())
 		{
-			QSettings(m_overridePath, QSettings::IniFormat).remove(overrideName);
-		}
-		else
-		{
-			saveOption(m_overridePath, overrideName, value, type);
-		}
+			QWriteLocker locker(&m_lock);
 
-		if (!m_hasWildcardedOverrides && overrideName.startsWith(QLatin1Char('*')))
-		{
-			m_hasWildcardedOverrides = true;
+			setOverrideValue(host, identifier, normalizeValue(identifier, value));
 		}
 
+		addPendingChange(host + QLatin1Char('/') + name, value, type, true);
+
 		emit m_instance->hostOptionChanged(identifier, value, host);
 
 		return;
@@ -384,7 +521,13 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 
 	if (getOption(identifier) != value)
 	{
-		saveOption(m_globalPath, name, value, type);
+		{
+			QWriteLocker locker(&m_lock);
+
+			m_values[identifier] = normalizeValue(identifier, value);
+		}
+
+		addPendingChange(name, value, type, false);
 
 		emit m_instance->optionChanged(identifier, value);
 	}
@@ -469,37 +612,73 @@ QString SettingsManager::getOptionName(int identifier)
 
 QVariant SettingsManager::getOption(int identifier, const QString &host)
 {
-	if (identifier < 0 || identifier >= m_definitions.count())
-	{
-		return {};
-	}
-
-	const QString name(getOptionName(identifier));
+	QReadLocker locker(&m_lock);
 
-	if (host.isEmpty())
+	if (identifier < 0 || identifier >= m_values.count())
 	{
-		return QSettings(m_globalPath, QSettings::IniFormat).value(name, m_definitions.at(identifier).defaultValue);
+		return ((identifier >= 0 && identifier < m_definitions.count()) ? m_definitions.at(identifier).defaultValue : QVariant());
 	}
 
-	const QString overrideName(host + QLatin1Char('/') + name);
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-
-	if (m_hasWildcardedOverrides && !overrides.contains(overrideName))
+	if (!host.isEmpty() && !m_overrides.isEmpty())
 	{
-		const QStringList hostParts(host.split(QLatin1Char('.')));
+		const QHash<QString, QHash<int, QVariant> >::const_iterator iterator(m_overrides.constFind(host));
+
+		if (iterator != m_overrides.constEnd() && iterator.value().contains(identifier))
+		{
+			return iterator.value().value(identifier);
+		}
 
-		for (int i = 1; i < hostParts.count(); ++i)
+		if (!m_wildcardedOverrides.isEmpty())
 		{
-			const QString wildcardedName(QLatin1String("*.") + hostParts.mid(i).join(QLatin1Char('.')) + QLatin1Char('/') + name);
+			int position(host.indexOf(QLatin1Char('.')));
 
-			if (overrides.contains(wildcardedName))
+			while (position >= 0)
 			{
-				return QSettings(m_overridePath, QSettings::IniFormat).value(wildcardedName, getOption(identifier));
+				const QHash<QString, QHash<int, QVariant> >::const_iterator wildcardedIterator(m_wildcardedOverrides.constFind(host.mid(position + 1)));
+
+				if (wildcardedIterator != m_wildcardedOverrides.constEnd() && wildcardedIterator.value().contains(identifier))
+				{
+					return wildcardedIterator.value().value(identifier);
+				}
+
+				position = host.indexOf(QLatin1Char('.'), (position + 1));
 			}
 		}
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).value(overrideName, getOption(identifier));
+	const QVariant &value(m_values.at(identifier));
+
+	return (value.isNull() ? m_definitions.at(identifier).defaultValue : value);
+}
+
+QVariant SettingsManager::normalizeValue(int identifier, const QVariant &value)
+{
+	if (value.type() != QVariant::String)
+	{
+		return value;
+	}
+
+	switch (m_definitions.at(identifier).type)
+	{
+		case BooleanType:
+			return value.toBool();
+		case IntegerType:
+			{
+				bool isValid(false);
+				const int number(value.toInt(&isValid));
+
+				if (isValid)
+				{
+					return number;
+				}
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return value;
 }
 
 QStringList SettingsManager::getOptions()
@@ -519,54 +698,53 @@ QStringList SettingsManager::getOptions()
 
 QStringList SettingsManager::getOverrideHosts(int identifier)
 {
+	QReadLocker locker(&m_lock);
+	QStringList hosts;
+
 	if (identifier < 0)
 	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups();
+		hosts = m_overrides.keys();
 	}
-
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
-	QStringList hosts;
-	const QString optionName(getOptionName(identifier));
-
-	for (int i = 0; i < overridesGroups.count(); ++i)
+	else
 	{
-		if (overrides.contains(overridesGroups.at(i) + QLatin1Char('/') + optionName))
+		QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
+
+		for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 		{
-			hosts.append(overridesGroups.at(i));
+			if (iterator.value().contains(identifier))
+			{
+				hosts.append(iterator.key());
+			}
 		}
 	}
 
+	hosts.sort();
+
 	return hosts;
 }
 
 QStringList SettingsManager::getOverridesHierarchy(const QString &host)
 {
+	QReadLocker locker(&m_lock);
 	QStringList hierarchy;
 
-	if (!m_hasWildcardedOverrides)
+	if (m_wildcardedOverrides.isEmpty())
 	{
 		return hierarchy;
 	}
 
-	const QStringList groups(QSettings(m_overridePath, QSettings::IniFormat).childGroups());
 	const QStringList hostParts(host.split(QLatin1Char('.')));
 
 	for (int i = 0; i < hostParts.count(); ++i)
 	{
 		const QString explicitHost(hostParts.mid(i).join(QLatin1Char('.')));
 
-		if (i > 0)
+		if (i > 0 && m_wildcardedOverrides.contains(explicitHost))
 		{
-			const QString wildcardedHost(QLatin1String("*.") + explicitHost);
-
-			if (groups.contains(wildcardedHost))
-			{
-				hierarchy.append(wildcardedHost);
-			}
+			hierarchy.append(QLatin1String("*.") + explicitHost);
 		}
 
-		if (groups.contains(explicitHost))
+		if (m_overrides.contains(explicitHost))
 		{
 			hierarchy.append(explicitHost);
 		}
@@ -578,30 +756,29 @@ QStringList SettingsManager::getOverridesHierarchy(const QString &host)
 DiagnosticReport::Section SettingsManager::createReport()
 {
 	QHash<QString, int> overridenValues;
-	QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
 	{
-		overrides.beginGroup(overridesGroups.at(i));
+		QReadLocker locker(&m_lock);
+		QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
 
-		const QStringList keys(overrides.allKeys());
-
-		for (int j = 0; j < keys.count(); ++j)
+		for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 		{
-			const QString key(keys.at(j));
+			const QList<int> options(iterator.value().keys());
 
-			if (overridenValues.contains(key))
-			{
-				++overridenValues[key];
-			}
-			else
+			for (int i = 0; i < options.count(); ++i)
 			{
-				overridenValues[key] = 1;
+				const QString key(getOptionName(options.at(i)));
+
+				if (overridenValues.contains(key))
+				{
+					++overridenValues[key];
+				}
+				else
+				{
+					overridenValues[key] = 1;
+				}
 			}
 		}
-
-		overrides.endGroup();
 	}
 
 	const QStringList options(getOptions());
@@ -666,7 +843,13 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 
 	m_customOptions[name] = identifier;
 
-	m_definitions.append(definition);
+	{
+		QWriteLocker locker(&m_lock);
+
+		m_definitions.append(definition);
+	}
+
+	loadOptions(identifier);
 
 	return identifier;
 }
@@ -691,14 +874,13 @@ int SettingsManager::getOptionIdentifier(const QString &name)
 
 int SettingsManager::getOverridesCount(int identifier)
 {
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
-	const QString optionName(getOptionName(identifier));
+	QReadLocker locker(&m_lock);
+	QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
 	int amount(0);
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
+	for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 	{
-		if (overrides.contains(overridesGroups.at(i) + QLatin1Char('/') + optionName))
+		if (iterator.value().contains(identifier))
 		{
 			++amount;
 		}
@@ -709,12 +891,14 @@ int SettingsManager::getOverridesCount(int identifier)
 
 bool SettingsManager::hasOverride(const QString &host, int identifier)
 {
+	QReadLocker locker(&m_lock);
+
 	if (identifier < 0)
 	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups().contains(host);
+		return m_overrides.contains(host);
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).contains(host + QLatin1Char('/') + getOptionName(identifier));
+	return m_overrides.value(host).contains(identifier);
 }
 
 bool SettingsManager::isDefault(int identifier)
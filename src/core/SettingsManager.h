@@ -24,6 +24,8 @@
 
 #include "Utils.h"
 
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSettings>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
 
@@ -48,6 +50,7 @@ public:
 		AddressField_ShowSuggestionsOnFocusOption,
 		AddressField_SuggestBookmarksOption,
 		AddressField_SuggestHistoryOption,
+		AddressField_SuggestHistoryLimitOption,
 		AddressField_SuggestLocalPathsOption,
 		AddressField_SuggestSearchOption,
 		AddressField_SuggestSpecialPagesOption,
@@ -76,6 +79,7 @@ public:
 		Browser_SpellCheckDictionaryOption,
 		Browser_SpellCheckIgnoreDctionariesOption,
 		Browser_StartupBehaviorOption,
+		Browser_TabsMemoryLimitOption,
 		Browser_TransferStartingActionOption,
 		Browser_ValidatorsOrderOption,
 		Cache_DiskCacheLimitOption,
@@ -106,7 +110,10 @@ public:
 		Content_ZoomTextOnlyOption,
 		ContentBlocking_EnableContentBlockingOption,
 		ContentBlocking_IgnoreHostsOption,
+		ContentBlocking_MatcherModeOption,
+		ContentBlocking_MergeProfilesOption,
 		ContentBlocking_ProfilesOption,
+		History_BrowsingDownsamplePeriodOption,
 		History_BrowsingLimitAmountGlobalOption,
 		History_BrowsingLimitAmountWindowOption,
 		History_BrowsingLimitPeriodOption,
@@ -326,20 +333,42 @@ public:
 	static bool isDefault(int identifier);
 
 protected:
+	struct PendingChange final
+	{
+		QString key;
+		QVariant value;
+		OptionType type = UnknownType;
+		bool isOverride = false;
+	};
+
 	explicit SettingsManager(QObject *parent);
+	~SettingsManager();
 
+	void timerEvent(QTimerEvent *event) override;
+	void scheduleSave();
 	static void registerOption(int identifier, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag | OptionDefinition::IsBuiltInFlag));
-	static void saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type);
+	static void loadOptions(int identifier = -1);
+	static void addPendingChange(const QString &key, const QVariant &value, OptionType type, bool isOverride);
+	static void saveOption(QSettings *settings, const QString &key, const QVariant &value, OptionType type);
+	static void savePendingChanges();
+	static void setOverrideValue(const QString &host, int identifier, const QVariant &value);
+	static QVariant normalizeValue(int identifier, const QVariant &value);
 
 private:
+	int m_saveTimer;
+
 	static SettingsManager *m_instance;
 	static QString m_globalPath;
 	static QString m_overridePath;
 	static QVector<OptionDefinition> m_definitions;
+	static QVector<QVariant> m_values;
+	static QVector<PendingChange> m_pendingChanges;
+	static QHash<QString, QHash<int, QVariant> > m_overrides;
+	static QHash<QString, QHash<int, QVariant> > m_wildcardedOverrides;
 	static QHash<QString, int> m_customOptions;
+	static QReadWriteLock m_lock;
 	static int m_identifierCounter;
 	static int m_optionIdentifierEnumerator;
-	static bool m_hasWildcardedOverrides;
 
 signals:
 	void optionChanged(int identifier, const QVariant &value);
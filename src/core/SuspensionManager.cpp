@@ -0,0 +1,273 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "SuspensionManager.h"
+#include "Application.h"
+#include "SettingsManager.h"
+#include "../ui/MainWindow.h"
+#include "../ui/Window.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QtMath>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace Otter
+{
+
+SuspensionManager* SuspensionManager::m_instance(nullptr);
+qint64 SuspensionManager::m_tabMemoryEstimate(52428800);
+qint64 SuspensionManager::m_reclaimedMemory(0);
+int SuspensionManager::m_suspendedTabsAmount(0);
+
+SuspensionManager::SuspensionManager(QObject *parent) : QObject(parent),
+	m_memoryUsageBeforeSuspension(0),
+	m_checkTimer(0),
+	m_measureTimer(0),
+	m_pendingTabsAmount(0)
+{
+	handleOptionChanged(SettingsManager::Browser_TabsMemoryLimitOption);
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &SuspensionManager::handleOptionChanged);
+}
+
+void SuspensionManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new SuspensionManager(QCoreApplication::instance());
+	}
+}
+
+void SuspensionManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_checkTimer)
+	{
+		if (m_measureTimer != 0)
+		{
+			return;
+		}
+
+		const qint64 limit(getMemoryLimit());
+		const qint64 usage(getMemoryUsage());
+
+		if (limit > 0 && usage > limit)
+		{
+			suspendTabs(qMax(static_cast<qint64>(1), static_cast<qint64>(qCeil(static_cast<qreal>(usage - limit) / m_tabMemoryEstimate))));
+		}
+	}
+	else if (event->timerId() == m_measureTimer)
+	{
+		killTimer(m_measureTimer);
+
+		m_measureTimer = 0;
+
+		const qint64 reclaimedMemory(qMax(static_cast<qint64>(0), (m_memoryUsageBeforeSuspension - getMemoryUsage())));
+
+		if (reclaimedMemory > 0)
+		{
+			m_tabMemoryEstimate = qMax(static_cast<qint64>(1048576), ((m_tabMemoryEstimate + (reclaimedMemory / m_pendingTabsAmount)) / 2));
+			m_reclaimedMemory += reclaimedMemory;
+
+			emit memoryReclaimed(reclaimedMemory);
+		}
+
+		m_pendingTabsAmount = 0;
+	}
+}
+
+void SuspensionManager::suspendTabs(qint64 amount)
+{
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QVector<Window*> windows;
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		const MainWindow *mainWindow(mainWindows.at(i));
+		const Window *activeWindow(mainWindow->getActiveWindow());
+
+		for (int j = 0; j < mainWindow->getWindowCount(); ++j)
+		{
+			Window *window(mainWindow->getWindowByIndex(j));
+
+			if (window && window != activeWindow && !window->isPinned() && !window->isAudible() && !window->isAboutToClose() && window->getLoadingState() != WebWidget::DeferredLoadingState)
+			{
+				windows.append(window);
+			}
+		}
+	}
+
+	if (windows.isEmpty())
+	{
+		return;
+	}
+
+	std::sort(windows.begin(), windows.end(), [&](Window *first, Window *second)
+	{
+		return (first->getLastActivity() < second->getLastActivity());
+	});
+
+	m_memoryUsageBeforeSuspension = getMemoryUsage();
+	m_pendingTabsAmount = 0;
+
+	for (int i = 0; (i < windows.count() && i < amount); ++i)
+	{
+		windows.at(i)->triggerAction(ActionsManager::SuspendTabAction);
+
+		if (windows.at(i)->getLoadingState() == WebWidget::DeferredLoadingState)
+		{
+			++m_pendingTabsAmount;
+		}
+	}
+
+	if (m_pendingTabsAmount > 0)
+	{
+		m_suspendedTabsAmount += m_pendingTabsAmount;
+		m_measureTimer = startTimer(2000);
+	}
+}
+
+void SuspensionManager::handleOptionChanged(int identifier)
+{
+	if (identifier != SettingsManager::Browser_TabsMemoryLimitOption)
+	{
+		return;
+	}
+
+	const bool isEnabled(getMemoryLimit() > 0);
+
+	if (isEnabled && m_checkTimer == 0)
+	{
+		m_checkTimer = startTimer(15000);
+	}
+	else if (!isEnabled && m_checkTimer != 0)
+	{
+		killTimer(m_checkTimer);
+
+		m_checkTimer = 0;
+	}
+}
+
+SuspensionManager* SuspensionManager::getInstance()
+{
+	return m_instance;
+}
+
+qint64 SuspensionManager::getMemoryUsage()
+{
+#ifdef Q_OS_LINUX
+	if (SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt() == 0 && getCgroupMemoryLimit() > 0)
+	{
+		return getCgroupMemoryUsage();
+	}
+
+	QFile file(QLatin1String("/proc/self/statm"));
+
+	if (file.open(QIODevice::ReadOnly))
+	{
+		const QList<QByteArray> values(file.readAll().split(' '));
+
+		if (values.count() > 1)
+		{
+			return (values.at(1).toLongLong() * sysconf(_SC_PAGESIZE));
+		}
+	}
+#endif
+
+	return -1;
+}
+
+qint64 SuspensionManager::getMemoryLimit()
+{
+	const int limit(SettingsManager::getOption(SettingsManager::Browser_TabsMemoryLimitOption).toInt());
+
+	if (limit > 0)
+	{
+		return (static_cast<qint64>(limit) * 1048576);
+	}
+
+	if (limit == 0)
+	{
+		const qint64 cgroupLimit(getCgroupMemoryLimit());
+
+		if (cgroupLimit > 0)
+		{
+			return ((cgroupLimit / 5) * 4);
+		}
+	}
+
+	return -1;
+}
+
+qint64 SuspensionManager::getCgroupMemoryUsage()
+{
+	return readCgroupValue({QLatin1String("/sys/fs/cgroup/memory.current"), QLatin1String("/sys/fs/cgroup/memory/memory.usage_in_bytes")});
+}
+
+qint64 SuspensionManager::getCgroupMemoryLimit()
+{
+	return readCgroupValue({QLatin1String("/sys/fs/cgroup/memory.max"), QLatin1String("/sys/fs/cgroup/memory/memory.limit_in_bytes")});
+}
+
+qint64 SuspensionManager::readCgroupValue(const QStringList &paths)
+{
+#ifdef Q_OS_LINUX
+	for (int i = 0; i < paths.count(); ++i)
+	{
+		QFile file(paths.at(i));
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			continue;
+		}
+
+		bool isValid(false);
+		const qint64 value(file.readAll().trimmed().toLongLong(&isValid));
+
+		if (isValid && value > 0 && value < (Q_INT64_C(1) << 60))
+		{
+			return value;
+		}
+
+		return -1;
+	}
+#endif
+
+	return -1;
+}
+
+qint64 SuspensionManager::getTabMemoryEstimate()
+{
+	return m_tabMemoryEstimate;
+}
+
+qint64 SuspensionManager::getReclaimedMemory()
+{
+	return m_reclaimedMemory;
+}
+
+int SuspensionManager::getSuspendedTabsAmount()
+{
+	return m_suspendedTabsAmount;
+}
+
+}
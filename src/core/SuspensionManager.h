@@ -0,0 +1,71 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SUSPENSIONMANAGER_H
+#define OTTER_SUSPENSIONMANAGER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+namespace Otter
+{
+
+class SuspensionManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static SuspensionManager* getInstance();
+	static qint64 getMemoryUsage();
+	static qint64 getMemoryLimit();
+	static qint64 getTabMemoryEstimate();
+	static qint64 getReclaimedMemory();
+	static int getSuspendedTabsAmount();
+
+protected:
+	explicit SuspensionManager(QObject *parent = nullptr);
+
+	void timerEvent(QTimerEvent *event) override;
+	void suspendTabs(qint64 amount);
+	static qint64 getCgroupMemoryUsage();
+	static qint64 getCgroupMemoryLimit();
+	static qint64 readCgroupValue(const QStringList &paths);
+
+protected slots:
+	void handleOptionChanged(int identifier);
+
+private:
+	qint64 m_memoryUsageBeforeSuspension;
+	int m_checkTimer;
+	int m_measureTimer;
+	int m_pendingTabsAmount;
+
+	static SuspensionManager *m_instance;
+	static qint64 m_tabMemoryEstimate;
+	static qint64 m_reclaimedMemory;
+	static int m_suspendedTabsAmount;
+
+signals:
+	void memoryReclaimed(qint64 amount);
+};
+
+}
+
+#endif
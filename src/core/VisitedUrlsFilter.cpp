@@ -0,0 +1,140 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "VisitedUrlsFilter.h"
+
+#include <QtCore/QHash>
+
+namespace Otter
+{
+
+const int VisitedUrlsFilter::BitsPerKey(10);
+const int VisitedUrlsFilter::HashesAmount(7);
+
+VisitedUrlsFilter::VisitedUrlsFilter() :
+	m_capacity(0),
+	m_keysAmount(0),
+	m_removedUrlsAmount(0)
+{
+}
+
+void VisitedUrlsFilter::clear()
+{
+	m_bits.fill(0);
+
+	m_keysAmount = 0;
+	m_removedUrlsAmount = 0;
+}
+
+void VisitedUrlsFilter::reserve(int amount)
+{
+	m_capacity = qMax(1024, (amount * 2));
+
+	m_bits.fill(0, (((static_cast<qint64>(m_capacity) * BitsPerKey) + 63) / 64));
+
+	m_keysAmount = 0;
+	m_removedUrlsAmount = 0;
+}
+
+void VisitedUrlsFilter::addUrl(const QUrl &url)
+{
+	if (m_bits.isEmpty())
+	{
+		reserve(0);
+	}
+
+	const QString text(url.toString(QUrl::FullyEncoded));
+
+	addKey(getKey(text));
+}
+
+void VisitedUrlsFilter::addKey(const QStringRef &key)
+{
+	const quint64 bitsAmount(static_cast<quint64>(m_bits.count()) * 64);
+	const quint64 firstHash(qHash(key, 0));
+	const quint64 secondHash(qHash(key, 0x9E3779B9) | 1);
+
+	for (int i = 0; i < HashesAmount; ++i)
+	{
+		const quint64 bit((firstHash + (i * secondHash)) % bitsAmount);
+
+		m_bits[static_cast<int>(bit / 64)] |= (static_cast<quint64>(1) << (bit % 64));
+	}
+
+	++m_keysAmount;
+}
+
+void VisitedUrlsFilter::markAsRemoved()
+{
+	++m_removedUrlsAmount;
+}
+
+QStringRef VisitedUrlsFilter::getKey(const QString &url)
+{
+	int length(url.indexOf(QLatin1Char('#')));
+
+	if (length < 0)
+	{
+		length = url.length();
+	}
+
+	while (length > 0 && url.at(length - 1) == QLatin1Char('/'))
+	{
+		--length;
+	}
+
+	return url.leftRef(length);
+}
+
+int VisitedUrlsFilter::getCapacity() const
+{
+	return m_capacity;
+}
+
+bool VisitedUrlsFilter::mayContain(const QString &url) const
+{
+	if (m_keysAmount == 0)
+	{
+		return false;
+	}
+
+	const QStringRef key(getKey(url));
+	const quint64 bitsAmount(static_cast<quint64>(m_bits.count()) * 64);
+	const quint64 firstHash(qHash(key, 0));
+	const quint64 secondHash(qHash(key, 0x9E3779B9) | 1);
+
+	for (int i = 0; i < HashesAmount; ++i)
+	{
+		const quint64 bit((firstHash + (i * secondHash)) % bitsAmount);
+
+		if ((m_bits.at(static_cast<int>(bit / 64)) & (static_cast<quint64>(1) << (bit % 64))) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool VisitedUrlsFilter::needsRebuild() const
+{
+	return (m_keysAmount > m_capacity || (m_removedUrlsAmount > 1024 && (m_removedUrlsAmount * 4) > m_keysAmount));
+}
+
+}
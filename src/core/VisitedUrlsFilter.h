@@ -0,0 +1,58 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_VISITEDURLSFILTER_H
+#define OTTER_VISITEDURLSFILTER_H
+
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class VisitedUrlsFilter final
+{
+public:
+	explicit VisitedUrlsFilter();
+
+	void clear();
+	void reserve(int amount);
+	void addUrl(const QUrl &url);
+	void markAsRemoved();
+	int getCapacity() const;
+	bool mayContain(const QString &url) const;
+	bool needsRebuild() const;
+
+protected:
+	void addKey(const QStringRef &key);
+	static QStringRef getKey(const QString &url);
+
+private:
+	QVector<quint64> m_bits;
+	int m_capacity;
+	int m_keysAmount;
+	int m_removedUrlsAmount;
+
+	static const int BitsPerKey;
+	static const int HashesAmount;
+};
+
+}
+
+#endif
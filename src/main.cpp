@@ -136,12 +136,13 @@ int main(int argc, char *argv[])
 	const QString session(commandLineParser->value(QLatin1String("session")).isEmpty() ? QLatin1String("default") : commandLineParser->value(QLatin1String("session")));
 	const QString startupBehavior(SettingsManager::getOption(SettingsManager::Browser_StartupBehaviorOption).toString());
 	const bool isPrivate(commandLineParser->isSet(QLatin1String("private-session")));
+	SessionInformation sessionData(SessionsManager::getSession(session));
 
-	if (!commandLineParser->value(QLatin1String("session")).isEmpty() && SessionsManager::getSession(session).isClean)
+	if (!commandLineParser->value(QLatin1String("session")).isEmpty() && sessionData.isClean)
 	{
-		SessionsManager::restoreSession(SessionsManager::getSession(session), nullptr, isPrivate);
+		SessionsManager::restoreSession(sessionData, nullptr, isPrivate);
 	}
-	else if (startupBehavior == QLatin1String("showDialog") || commandLineParser->isSet(QLatin1String("session-chooser")) || !SessionsManager::getSession(session).isClean)
+	else if (startupBehavior == QLatin1String("showDialog") || commandLineParser->isSet(QLatin1String("session-chooser")) || !sessionData.isClean)
 	{
 		StartupDialog dialog(session);
 
@@ -154,11 +155,10 @@ int main(int argc, char *argv[])
 	}
 	else if (startupBehavior == QLatin1String("continuePrevious"))
 	{
-		SessionsManager::restoreSession(SessionsManager::getSession(QLatin1String("default")), nullptr, isPrivate);
+		SessionsManager::restoreSession(sessionData, nullptr, isPrivate);
 	}
 	else
 	{
-		SessionInformation sessionData(SessionsManager::getSession(QLatin1String("default")));
 		sessionData.path = QLatin1String("default");
 		sessionData.title = QCoreApplication::translate("main", "Default");
 
@@ -32,6 +32,8 @@
 #include "../../../../ui/LineEditWidget.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QRegularExpression>
 #include <QtWebEngineWidgets/QWebEngineHistory>
 #include <QtWebEngineWidgets/QWebEngineProfile>
@@ -176,21 +178,6 @@ void QtWebEnginePage::handleLoadFinished()
 	{
 		if (m_widget)
 		{
-			const QUrl url(m_widget->getUrl());
-			const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
-
-			if (!cosmeticFilters.rules.isEmpty() || !cosmeticFilters.exceptions.isEmpty())
-			{
-				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideElements.js"));
-
-				if (file.open(QIODevice::ReadOnly))
-				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(cosmeticFilters.exceptions), createJavaScriptList(cosmeticFilters.rules)));
-
-					file.close();
-				}
-			}
-
 			const QStringList blockedRequests(m_widget->getBlockedElements());
 
 			if (!blockedRequests.isEmpty())
@@ -347,6 +334,61 @@ QtWebEngineWebWidget* QtWebEnginePage::createWidget(SessionsManager::OpenHints h
 	return widget;
 }
 
+void QtWebEnginePage::updateCosmeticFilters(const QUrl &url)
+{
+	const QVector<int> profiles(m_widget ? ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList()) : QVector<int>());
+	const QString genericStyleSheet(ContentFiltersManager::getGenericCosmeticFiltersStyleSheet(profiles));
+	const QWebEngineScript genericScript(scripts().findScript(QLatin1String("otter-generic-cosmetic-filters")));
+
+	if (genericScript.isNull() || genericStyleSheet != m_cosmeticFiltersStyleSheet)
+	{
+		if (!genericScript.isNull())
+		{
+			scripts().remove(genericScript);
+		}
+
+		m_cosmeticFiltersStyleSheet = genericStyleSheet;
+
+		if (!genericStyleSheet.isEmpty())
+		{
+			QWebEngineScript script;
+			script.setName(QLatin1String("otter-generic-cosmetic-filters"));
+			script.setSourceCode(createStyleSheetScriptSource(QLatin1String("otter-generic-cosmetic-filters"), genericStyleSheet, false));
+			script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+			script.setWorldId(QWebEngineScript::ApplicationWorld);
+			script.setRunsOnSubFrames(true);
+
+			scripts().insert(script);
+		}
+	}
+
+	const ContentFiltersManager::CosmeticFiltersStyleSheet styleSheet(ContentFiltersManager::getCosmeticFiltersStyleSheet(profiles, url));
+
+	if (styleSheet.isOverridingGenericStyleSheet && !genericStyleSheet.isEmpty())
+	{
+		QWebEngineScript script;
+		script.setName(QLatin1String("otter-generic-cosmetic-filters-override"));
+		script.setSourceCode(createStyleSheetScriptSource(QLatin1String("otter-generic-cosmetic-filters"), styleSheet.genericStyleSheet, true));
+		script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+		script.setWorldId(QWebEngineScript::ApplicationWorld);
+		script.setRunsOnSubFrames(true);
+
+		scripts().insert(script);
+	}
+
+	if (!styleSheet.styleSheet.isEmpty())
+	{
+		QWebEngineScript script;
+		script.setName(QLatin1String("otter-domain-cosmetic-filters"));
+		script.setSourceCode(createStyleSheetScriptSource(QLatin1String("otter-domain-cosmetic-filters"), styleSheet.styleSheet, true));
+		script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+		script.setWorldId(QWebEngineScript::ApplicationWorld);
+		script.setRunsOnSubFrames(true);
+
+		scripts().insert(script);
+	}
+}
+
 QString QtWebEnginePage::createJavaScriptList(const QStringList &rules) const
 {
 	if (rules.isEmpty())
@@ -364,6 +406,11 @@ QString QtWebEnginePage::createJavaScriptList(const QStringList &rules) const
 	return QLatin1Char('\'') + parsedRules.join(QLatin1String("','")) + QLatin1Char('\'');
 }
 
+QString QtWebEnginePage::createStyleSheetScriptSource(const QString &identifier, const QString &styleSheet, bool canReplace) const
+{
+	return createScriptSource(QLatin1String("applyStyleSheet"), {QString::fromUtf8(QJsonDocument(QJsonArray({identifier, styleSheet, canReplace})).toJson(QJsonDocument::Compact))});
+}
+
 QString QtWebEnginePage::createScriptSource(const QString &path, const QStringList &parameters) const
 {
 	QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/") + path + QLatin1String(".js"));
@@ -569,7 +616,17 @@ bool QtWebEnginePage::acceptNavigationRequest(const QUrl &url, NavigationType ty
 		}
 	}
 
-	scripts().clear();
+	const QList<QWebEngineScript> previousScripts(scripts().toList());
+
+	for (int i = 0; i < previousScripts.count(); ++i)
+	{
+		if (previousScripts.at(i).name() != QLatin1String("otter-generic-cosmetic-filters"))
+		{
+			scripts().remove(previousScripts.at(i));
+		}
+	}
+
+	updateCosmeticFilters(url);
 
 	const QVector<UserScript*> userScripts(UserScript::getUserScriptsForUrl(url));
 
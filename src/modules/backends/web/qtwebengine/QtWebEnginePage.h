@@ -66,7 +66,9 @@ protected:
 	void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel level, const QString &note, int line, const QString &source) override;
 	QWebEnginePage* createWindow(WebWindowType type) override;
 	QtWebEngineWebWidget* createWidget(SessionsManager::OpenHints hints);
+	void updateCosmeticFilters(const QUrl &url);
 	QString createJavaScriptList(const QStringList &rules) const;
+	QString createStyleSheetScriptSource(const QString &identifier, const QString &styleSheet, bool canReplace) const;
 	QStringList chooseFiles(FileSelectionMode mode, const QStringList &oldFiles, const QStringList &acceptedMimeTypes) override;
 	bool acceptNavigationRequest(const QUrl &url, NavigationType type, bool isMainFrame) override;
 	bool certificateError(const QWebEngineCertificateError &error) override;
@@ -82,6 +84,7 @@ private:
 	WebWidget::SslInformation m_sslInformation;
 	QVector<QtWebEnginePage*> m_popups;
 	QVector<HistoryEntryInformation> m_history;
+	QString m_cosmeticFiltersStyleSheet;
 	NavigationType m_previousNavigationType;
 	bool m_isIgnoringJavaScriptPopups;
 	bool m_isViewingMedia;
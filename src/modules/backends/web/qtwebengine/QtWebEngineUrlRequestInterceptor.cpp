@@ -21,7 +21,6 @@
 #include "QtWebEngineUrlRequestInterceptor.h"
 #include "../../../../core/Console.h"
 #include "../../../../core/ContentFiltersManager.h"
-#include "../../../../core/SettingsManager.h"
 #include "../../../../core/Utils.h"
 #include "../../../../core/WebBackend.h"
 
@@ -159,45 +158,26 @@ void QtWebEngineUrlRequestInterceptor::updateOptions(const QUrl &url)
 		m_backend = AddonsManager::getWebBackend(QLatin1String("qtwebengine"));
 	}
 
-	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption, url).toBool())
-	{
-		m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList());
-	}
-	else
-	{
-		m_contentBlockingProfiles.clear();
-	}
+	const NetworkManagerFactory::NetworkPolicy policy(getNetworkPolicy(url));
 
-	QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption, url).toString());
-	acceptLanguage = ((acceptLanguage.isEmpty()) ? QLatin1String(" ") : acceptLanguage.replace(QLatin1String("system"), QLocale::system().bcp47Name()));
-
-	m_acceptLanguage = ((acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : acceptLanguage);
-	m_userAgent = m_backend->getUserAgent(NetworkManagerFactory::getUserAgent(getOption(SettingsManager::Network_UserAgentOption, url).toString()).value);
-	m_unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption, url).toStringList();
-
-	const QString doNotTrackPolicyValue(getOption(SettingsManager::Network_DoNotTrackPolicyOption, url).toString());
+	m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(policy.contentBlockingProfiles);
+	m_acceptLanguage = ((policy.acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : policy.acceptLanguage);
+	m_userAgent = m_backend->getUserAgent(policy.userAgent);
+	m_unblockedHosts = policy.unblockedHosts;
+	m_doNotTrackPolicy = policy.doNotTrackPolicy;
+	m_areImagesEnabled = policy.areImagesEnabled;
+	m_canSendReferrer = policy.canSendReferrer;
+	m_isWorkingOffline = policy.isWorkingOffline;
+}
 
-	if (doNotTrackPolicyValue == QLatin1String("allow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::AllowToTrackPolicy;
-	}
-	else if (doNotTrackPolicyValue == QLatin1String("doNotAllow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::DoNotAllowToTrackPolicy;
-	}
-	else
+NetworkManagerFactory::NetworkPolicy QtWebEngineUrlRequestInterceptor::getNetworkPolicy(const QUrl &url) const
+{
+	if (m_widget)
 	{
-		m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
+		return NetworkManagerFactory::getNetworkPolicy(Utils::extractHost(url.isEmpty() ? m_widget->getUrl() : url), m_widget->getOptions());
 	}
 
-	m_areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption, url).toString() != QLatin1String("disabled"));
-	m_canSendReferrer = getOption(SettingsManager::Network_EnableReferrerOption, url).toBool();
-	m_isWorkingOffline = getOption(SettingsManager::Network_WorkOfflineOption, url).toBool();
-}
-
-QVariant QtWebEngineUrlRequestInterceptor::getOption(int identifier, const QUrl &url) const
-{
-	return (m_widget ? m_widget->getOption(identifier, url) : SettingsManager::getOption(identifier, Utils::extractHost(url)));
+	return NetworkManagerFactory::getNetworkPolicy(Utils::extractHost(url));
 }
 
 QVariant QtWebEngineUrlRequestInterceptor::getPageInformation(WebWidget::PageInformation key) const
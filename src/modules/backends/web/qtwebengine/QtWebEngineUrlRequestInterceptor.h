@@ -43,7 +43,7 @@ public:
 
 protected:
 	void updateOptions(const QUrl &url);
-	QVariant getOption(int identifier, const QUrl &url) const;
+	NetworkManagerFactory::NetworkPolicy getNetworkPolicy(const QUrl &url) const;
 	QVariant getPageInformation(WebWidget::PageInformation key) const;
 
 protected slots:
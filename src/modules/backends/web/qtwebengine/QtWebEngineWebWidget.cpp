@@ -1112,7 +1112,7 @@ void QtWebEngineWebWidget::notifyUrlChanged()
 	emit urlChanged((url.toString() == QLatin1String("about:blank")) ? m_page->requestedUrl() : url);
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(getWindowIdentifier());
 }
 
 void QtWebEngineWebWidget::notifyIconChanged()
@@ -1347,7 +1347,7 @@ void QtWebEngineWebWidget::setZoom(int zoom)
 	{
 		m_page->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(getWindowIdentifier());
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
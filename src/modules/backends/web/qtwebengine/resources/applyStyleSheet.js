@@ -0,0 +1,44 @@
+function applyStyleSheet(identifier, styleSheet, canReplace)
+{
+	function insertStyleSheet()
+	{
+		let element = document.getElementById(identifier);
+
+		if (element)
+		{
+			if (canReplace)
+			{
+				element.textContent = styleSheet;
+			}
+
+			return;
+		}
+
+		element = document.createElement('style');
+		element.id = identifier;
+		element.textContent = styleSheet;
+
+		(document.head || document.documentElement).appendChild(element);
+	}
+
+	if (document.documentElement)
+	{
+		insertStyleSheet();
+
+		return;
+	}
+
+	let observer = new MutationObserver(function()
+	{
+		if (document.documentElement)
+		{
+			observer.disconnect();
+
+			insertStyleSheet();
+		}
+	});
+
+	observer.observe(document, {childList: true});
+}
+
+applyStyleSheet.apply(null, %1);
@@ -20,6 +20,7 @@
 #ifndef OTTER_QTWEBKITHISTORYINTERFACE_H
 #define OTTER_QTWEBKITHISTORYINTERFACE_H
 
+#include <QtCore/QSet>
 #include <QtCore/QStringList>
 #include <QtWebKit/QWebHistoryInterface>
 
@@ -40,7 +41,8 @@ protected slots:
 	void clear();
 
 private:
-	QStringList m_urls;
+	QSet<QString> m_urls;
+	QStringList m_recentUrls;
 };
 
 }
@@ -446,88 +446,20 @@ void QtWebKitNetworkManager::updateOptions(const QUrl &url)
 		m_backend = AddonsManager::getWebBackend(QLatin1String("qtwebkit"));
 	}
 
-	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption, url).toBool())
-	{
-		m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList());
-	}
-	else
-	{
-		m_contentBlockingProfiles.clear();
-	}
-
-	QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption, url).toString());
-	acceptLanguage = ((acceptLanguage.isEmpty()) ? QLatin1String(" ") : acceptLanguage.replace(QLatin1String("system"), QLocale::system().bcp47Name()));
-
-	m_acceptLanguage = ((acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : acceptLanguage);
-	m_userAgent = m_backend->getUserAgent(NetworkManagerFactory::getUserAgent(getOption(SettingsManager::Network_UserAgentOption, url).toString()).value);
-	m_unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption, url).toStringList();
-
-	const QString doNotTrackPolicyValue(getOption(SettingsManager::Network_DoNotTrackPolicyOption, url).toString());
-
-	if (doNotTrackPolicyValue == QLatin1String("allow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::AllowToTrackPolicy;
-	}
-	else if (doNotTrackPolicyValue == QLatin1String("doNotAllow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::DoNotAllowToTrackPolicy;
-	}
-	else
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
-	}
-
-	m_areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption, url).toString() != QLatin1String("disabled"));
-	m_canSendReferrer = getOption(SettingsManager::Network_EnableReferrerOption, url).toBool();
-	m_isWorkingOffline = getOption(SettingsManager::Network_WorkOfflineOption, url).toBool();
-
-	const QString generalCookiesPolicyValue(getOption(SettingsManager::Network_CookiesPolicyOption, url).toString());
-	CookieJar::CookiesPolicy generalCookiesPolicy(CookieJar::AcceptAllCookies);
-
-	if (generalCookiesPolicyValue == QLatin1String("ignore"))
-	{
-		generalCookiesPolicy = CookieJar::IgnoreCookies;
-	}
-	else if (generalCookiesPolicyValue == QLatin1String("readOnly"))
-	{
-		generalCookiesPolicy = CookieJar::ReadOnlyCookies;
-	}
-	else if (generalCookiesPolicyValue == QLatin1String("acceptExisting"))
-	{
-		generalCookiesPolicy = CookieJar::AcceptExistingCookies;
-	}
-
-	const QString thirdPartyCookiesPolicyValue(getOption(SettingsManager::Network_ThirdPartyCookiesPolicyOption, url).toString());
-	CookieJar::CookiesPolicy thirdPartyCookiesPolicy(CookieJar::AcceptAllCookies);
-
-	if (thirdPartyCookiesPolicyValue == QLatin1String("ignore"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::IgnoreCookies;
-	}
-	else if (thirdPartyCookiesPolicyValue == QLatin1String("readOnly"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::ReadOnlyCookies;
-	}
-	else if (thirdPartyCookiesPolicyValue == QLatin1String("acceptExisting"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::AcceptExistingCookies;
-	}
+	const NetworkManagerFactory::NetworkPolicy policy(getNetworkPolicy(url));
 
-	const QString keepCookiesModeValue(getOption(SettingsManager::Network_CookiesKeepModeOption, url).toString());
-	CookieJar::KeepMode keepCookiesMode(CookieJar::KeepUntilExpiresMode);
+	m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(policy.contentBlockingProfiles);
+	m_acceptLanguage = ((policy.acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : policy.acceptLanguage);
+	m_userAgent = m_backend->getUserAgent(policy.userAgent);
+	m_unblockedHosts = policy.unblockedHosts;
+	m_doNotTrackPolicy = policy.doNotTrackPolicy;
+	m_areImagesEnabled = policy.areImagesEnabled;
+	m_canSendReferrer = policy.canSendReferrer;
+	m_isWorkingOffline = policy.isWorkingOffline;
 
-	if (keepCookiesModeValue == QLatin1String("keepUntilExit"))
-	{
-		keepCookiesMode = CookieJar::KeepUntilExitMode;
-	}
-	else if (keepCookiesModeValue == QLatin1String("ask"))
-	{
-		keepCookiesMode = CookieJar::AskIfKeepMode;
-	}
-
-	m_cookieJarProxy->setup(getOption(SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption, url).toStringList(), getOption(SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption, url).toStringList(), generalCookiesPolicy, thirdPartyCookiesPolicy, keepCookiesMode);
+	m_cookieJarProxy->setup(policy.thirdPartyCookiesAcceptedHosts, policy.thirdPartyCookiesRejectedHosts, policy.cookiesPolicy, policy.thirdPartyCookiesPolicy, policy.cookiesKeepMode);
 
-	if (!m_proxyFactory && ((m_widget && m_widget->hasOption(SettingsManager::Network_ProxyOption)) || SettingsManager::hasOverride(Utils::extractHost(url), SettingsManager::Network_ProxyOption)))
+	if (!m_proxyFactory && policy.hasProxyOverride)
 	{
 		m_proxyFactory = new NetworkProxyFactory(this);
 
@@ -536,7 +468,7 @@ void QtWebKitNetworkManager::updateOptions(const QUrl &url)
 
 	if (m_proxyFactory)
 	{
-		m_proxyFactory->setProxy(getOption(SettingsManager::Network_ProxyOption, url).toString());
+		m_proxyFactory->setProxy(policy.proxy);
 	}
 }
 
@@ -824,6 +756,16 @@ QVariant QtWebKitNetworkManager::getOption(int identifier, const QUrl &url) cons
 	return (m_widget ? m_widget->getOption(identifier, url) : SettingsManager::getOption(identifier, Utils::extractHost(url)));
 }
 
+NetworkManagerFactory::NetworkPolicy QtWebKitNetworkManager::getNetworkPolicy(const QUrl &url) const
+{
+	if (m_widget)
+	{
+		return NetworkManagerFactory::getNetworkPolicy(Utils::extractHost(url.isEmpty() ? m_widget->getUrl() : url), m_widget->getOptions());
+	}
+
+	return NetworkManagerFactory::getNetworkPolicy(Utils::extractHost(url));
+}
+
 QVariant QtWebKitNetworkManager::getPageInformation(WebWidget::PageInformation key) const
 {
 	if (key == WebWidget::RequestsBlockedInformation)
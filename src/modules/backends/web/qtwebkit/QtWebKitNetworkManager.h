@@ -71,6 +71,7 @@ protected:
 	QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData) override;
 	QString getUserAgent() const;
 	QVariant getOption(int identifier, const QUrl &url) const;
+	NetworkManagerFactory::NetworkPolicy getNetworkPolicy(const QUrl &url) const;
 
 protected slots:
 	void handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
@@ -1513,7 +1513,7 @@ void QtWebKitWebWidget::handleHistory()
 			m_isTypedIn = false;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(getWindowIdentifier());
 		BookmarksManager::updateVisits(url.toString());
 	}
 }
@@ -1601,7 +1601,7 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 	emit arbitraryActionsStateChanged({ActionsManager::InspectPageAction, ActionsManager::InspectElementAction});
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::NavigationCategory, ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(getWindowIdentifier());
 }
 
 void QtWebKitWebWidget::notifyIconChanged()
@@ -1853,7 +1853,7 @@ void QtWebKitWebWidget::setZoom(int zoom)
 	{
 		m_page->mainFrame()->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(getWindowIdentifier());
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
@@ -27,8 +27,10 @@
 #include "../../../core/ThemesManager.h"
 #include "../../../core/Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeDatabase>
 #include <QtWidgets/QFileIconProvider>
 
@@ -37,6 +39,7 @@ namespace Otter
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
 	m_types(NoCompletionType),
+	m_localPathsPosition(0),
 	m_updateTimer(0),
 	m_showCompletionCategories(true)
 {
@@ -59,8 +62,19 @@ void AddressCompletionModel::timerEvent(QTimerEvent *event)
 	}
 }
 
+void AddressCompletionModel::cancelLocalPaths()
+{
+	if (m_localPathsCancellation)
+	{
+		m_localPathsCancellation->storeRelease(1);
+		m_localPathsCancellation.clear();
+	}
+}
+
 void AddressCompletionModel::updateModel()
 {
+	cancelLocalPaths();
+
 	QVector<CompletionEntry> completions;
 	completions.reserve(10);
 
@@ -125,36 +139,16 @@ void AddressCompletionModel::updateModel()
 		}
 	}
 
+	m_localPathsPosition = completions.count();
+
 	if (m_types.testFlag(LocalPathSuggestionsCompletionType) && (m_filter == QString(QLatin1Char('~')) || m_filter.contains(QDir::separator())))
 	{
-		const QString directory((m_filter == QString(QLatin1Char('~'))) ? QDir::homePath() : m_filter.section(QDir::separator(), 0, -2) + QDir::separator());
-		const QString prefix(m_filter.contains(QDir::separator()) ? m_filter.section(QDir::separator(), -1, -1) : QString());
-		const QList<QFileInfo> entries(QDir(Utils::normalizePath(directory)).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot));
-		const QFileIconProvider iconProvider;
-		const QMimeDatabase mimeDatabase;
-		bool headerWasAdded(!m_showCompletionCategories);
-
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			if (entries.at(i).fileName().startsWith(prefix, Qt::CaseInsensitive))
-			{
-				const QString path(directory + entries.at(i).fileName());
-
-				if (!headerWasAdded)
-				{
-					completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
-
-					headerWasAdded = true;
-				}
-
-				completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(path)), path, path, QIcon::fromTheme(mimeDatabase.mimeTypeForFile(entries.at(i), QMimeDatabase::MatchExtension).iconName(), iconProvider.icon(entries.at(i))), {}, CompletionEntry::LocalPathType));
-			}
-		}
+		updateLocalPaths(((m_filter == QString(QLatin1Char('~'))) ? QDir::homePath() : m_filter.section(QDir::separator(), 0, -2) + QDir::separator()), (m_filter.contains(QDir::separator()) ? m_filter.section(QDir::separator(), -1, -1) : QString()));
 	}
 
 	if (m_types.testFlag(HistoryCompletionType))
 	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter));
+		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter, false, SettingsManager::getOption(SettingsManager::AddressField_SuggestHistoryLimitOption).toInt()));
 
 		if (m_showCompletionCategories && !entries.isEmpty())
 		{
@@ -163,7 +157,7 @@ void AddressCompletionModel::updateModel()
 
 		for (int i = 0; i < entries.count(); ++i)
 		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), (entries.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType)));
+			completions.append(CompletionEntry(entries.at(i).url, entries.at(i).title, entries.at(i).match, entries.at(i).icon, entries.at(i).timeVisited, (entries.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType)));
 		}
 	}
 
@@ -178,7 +172,7 @@ void AddressCompletionModel::updateModel()
 
 		for (int i = 0; i < entries.count(); ++i)
 		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), CompletionEntry::TypedHistoryType, entries.at(i).entry->getIdentifier()));
+			completions.append(CompletionEntry(entries.at(i).url, entries.at(i).title, entries.at(i).match, entries.at(i).icon, entries.at(i).timeVisited, CompletionEntry::TypedHistoryType, entries.at(i).identifier));
 		}
 	}
 
@@ -207,15 +201,126 @@ void AddressCompletionModel::updateModel()
 
 	completions.squeeze();
 
-	beginResetModel();
+	setCompletions(completions);
+}
+
+void AddressCompletionModel::updateLocalPaths(const QString &directory, const QString &prefix)
+{
+	const QString filter(m_filter);
+	const QSharedPointer<QAtomicInt> cancellation(new QAtomicInt(0));
+	QFutureWatcher<QVector<LocalPathEntry> > *watcher(new QFutureWatcher<QVector<LocalPathEntry> >(this));
+
+	m_localPathsCancellation = cancellation;
+
+	connect(watcher, &QFutureWatcher<QVector<LocalPathEntry> >::finished, this, [=]()
+	{
+		const QVector<LocalPathEntry> entries(watcher->result());
+
+		watcher->deleteLater();
+
+		if (cancellation->loadAcquire() != 0 || filter != m_filter)
+		{
+			return;
+		}
+
+		m_localPathsCancellation.clear();
+
+		if (entries.isEmpty())
+		{
+			return;
+		}
+
+		const QFileIconProvider iconProvider;
+		QVector<CompletionEntry> completions;
+		completions.reserve(entries.count() + 1);
+
+		if (m_showCompletionCategories)
+		{
+			completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
+		}
+
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			const LocalPathEntry &entry(entries.at(i));
+
+			completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(entry.path)), entry.path, entry.path, QIcon::fromTheme(entry.iconName, iconProvider.icon(entry.isDirectory ? QFileIconProvider::Folder : QFileIconProvider::File)), {}, CompletionEntry::LocalPathType));
+		}
+
+		const int position(qMin(m_localPathsPosition, m_completions.count()));
+
+		beginInsertRows({}, position, (position + completions.count() - 1));
+
+		for (int i = 0; i < completions.count(); ++i)
+		{
+			m_completions.insert((position + i), completions.at(i));
+		}
 
-	m_completions = completions;
+		endInsertRows();
 
-	endResetModel();
+		emit completionReady(m_filter);
+	});
+
+	watcher->setFuture(QtConcurrent::run(&AddressCompletionModel::listLocalPaths, directory, prefix, cancellation));
+}
+
+void AddressCompletionModel::setCompletions(const QVector<CompletionEntry> &completions)
+{
+	int prefixAmount(0);
+	int suffixAmount(0);
+
+	while (prefixAmount < m_completions.count() && prefixAmount < completions.count() && isSameEntry(m_completions.at(prefixAmount), completions.at(prefixAmount)))
+	{
+		++prefixAmount;
+	}
+
+	while (suffixAmount < (m_completions.count() - prefixAmount) && suffixAmount < (completions.count() - prefixAmount) && isSameEntry(m_completions.at(m_completions.count() - suffixAmount - 1), completions.at(completions.count() - suffixAmount - 1)))
+	{
+		++suffixAmount;
+	}
+
+	const int removedAmount(m_completions.count() - prefixAmount - suffixAmount);
+	const int insertedAmount(completions.count() - prefixAmount - suffixAmount);
+
+	if (removedAmount > 0)
+	{
+		beginRemoveRows({}, prefixAmount, (prefixAmount + removedAmount - 1));
+
+		m_completions.remove(prefixAmount, removedAmount);
+
+		endRemoveRows();
+	}
+
+	if (insertedAmount > 0)
+	{
+		beginInsertRows({}, prefixAmount, (prefixAmount + insertedAmount - 1));
+
+		m_completions = completions;
+
+		endInsertRows();
+	}
+	else
+	{
+		m_completions = completions;
+	}
+
+	if (prefixAmount > 0)
+	{
+		emit dataChanged(index(0), index(prefixAmount - 1));
+	}
+
+	if (suffixAmount > 0)
+	{
+		emit dataChanged(index(m_completions.count() - suffixAmount), index(m_completions.count() - 1));
+	}
 }
 
 void AddressCompletionModel::setFilter(const QString &filter)
 {
+	if (filter != m_filter)
+	{
+		cancelLocalPaths();
+	}
+
 	m_filter = filter;
 	m_showCompletionCategories = SettingsManager::getOption(SettingsManager::AddressField_ShowCompletionCategoriesOption).toBool();
 
@@ -228,11 +333,7 @@ void AddressCompletionModel::setFilter(const QString &filter)
 			m_updateTimer = 0;
 		}
 
-		beginResetModel();
-
-		m_completions.clear();
-
-		endResetModel();
+		setCompletions({});
 
 		emit completionReady({});
 	}
@@ -264,6 +365,33 @@ void AddressCompletionModel::setTypes(CompletionTypes types, bool force)
 	updateModel();
 }
 
+QVector<AddressCompletionModel::LocalPathEntry> AddressCompletionModel::listLocalPaths(const QString &directory, const QString &prefix, const QSharedPointer<QAtomicInt> &cancellation)
+{
+	const QList<QFileInfo> entries(QDir(Utils::normalizePath(directory)).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot));
+	const QMimeDatabase mimeDatabase;
+	QVector<LocalPathEntry> paths;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (cancellation->loadAcquire() != 0)
+		{
+			return {};
+		}
+
+		if (entries.at(i).fileName().startsWith(prefix, Qt::CaseInsensitive))
+		{
+			LocalPathEntry entry;
+			entry.path = directory + entries.at(i).fileName();
+			entry.iconName = mimeDatabase.mimeTypeForFile(entries.at(i), QMimeDatabase::MatchExtension).iconName();
+			entry.isDirectory = entries.at(i).isDir();
+
+			paths.append(entry);
+		}
+	}
+
+	return paths;
+}
+
 QVariant AddressCompletionModel::data(const QModelIndex &index, int role) const
 {
 	if (index.column() != 0 || !(index.row() >= 0 && index.row() < m_completions.count()))
@@ -324,6 +452,11 @@ int AddressCompletionModel::rowCount(const QModelIndex &index) const
 	return (index.isValid() ? 0 : m_completions.count());
 }
 
+bool AddressCompletionModel::isSameEntry(const CompletionEntry &first, const CompletionEntry &second)
+{
+	return (first.type == second.type && first.url == second.url && first.title == second.title && first.text == second.text && first.keyword == second.keyword);
+}
+
 bool AddressCompletionModel::event(QEvent *event)
 {
 	if (event->type() == QEvent::LanguageChange && m_completions.count() > 0)
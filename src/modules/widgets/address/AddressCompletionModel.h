@@ -25,6 +25,8 @@
 #include "../../../core/SearchEnginesManager.h"
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -105,14 +107,28 @@ public slots:
 	void setFilter(const QString &filter = {});
 
 protected:
+	struct LocalPathEntry final
+	{
+		QString path;
+		QString iconName;
+		bool isDirectory = false;
+	};
+
 	void timerEvent(QTimerEvent *event) override;
+	void cancelLocalPaths();
 	void updateModel();
+	void updateLocalPaths(const QString &directory, const QString &prefix);
+	void setCompletions(const QVector<CompletionEntry> &completions);
+	static QVector<LocalPathEntry> listLocalPaths(const QString &directory, const QString &prefix, const QSharedPointer<QAtomicInt> &cancellation);
+	static bool isSameEntry(const CompletionEntry &first, const CompletionEntry &second);
 
 private:
 	QVector<CompletionEntry> m_completions;
 	QString m_filter;
 	SearchEnginesManager::SearchEngineDefinition m_defaultSearchEngine;
+	QSharedPointer<QAtomicInt> m_localPathsCancellation;
 	AddressCompletionModel::CompletionTypes m_types;
+	int m_localPathsPosition;
 	int m_updateTimer;
 	bool m_showCompletionCategories;
 
@@ -339,6 +339,10 @@ AddressWidget::AddressWidget(Window *window, QWidget *parent) : LineEditWidget(p
 	{
 		updateEntries({BookmarkEntry});
 	});
+	connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, [&]()
+	{
+		updateEntries({BookmarkEntry});
+	});
 }
 
 void AddressWidget::changeEvent(QEvent *event)
@@ -376,7 +380,7 @@ void AddressWidget::paintEvent(QPaintEvent *event)
 		dropdownArrowOption.initFrom(this);
 		dropdownArrowOption.rect = m_entries[HistoryDropdownEntry].rectangle;
 
-		if (HistoryManager::getTypedHistoryModel()->rowCount() == 0)
+		if (HistoryManager::getTypedHistoryModel()->getEntriesAmount() == 0)
 		{
 			dropdownArrowOption.palette.setCurrentColorGroup(QPalette::Disabled);
 		}
@@ -431,7 +435,7 @@ void AddressWidget::keyPressEvent(QKeyEvent *event)
 	switch (event->key())
 	{
 		case Qt::Key_Down:
-			if (!isPopupVisible() && HistoryManager::getTypedHistoryModel()->rowCount() > 0)
+			if (!isPopupVisible() && HistoryManager::getTypedHistoryModel()->getEntriesAmount() > 0)
 			{
 				showCompletion(true);
 			}
@@ -696,7 +700,7 @@ void AddressWidget::mouseReleaseEvent(QMouseEvent *event)
 
 				return;
 			case HistoryDropdownEntry:
-				if (!isPopupVisible() && HistoryManager::getTypedHistoryModel()->rowCount() > 0)
+				if (!isPopupVisible() && HistoryManager::getTypedHistoryModel()->getEntriesAmount() > 0)
 				{
 					showCompletion(true);
 				}
@@ -707,7 +711,7 @@ void AddressWidget::mouseReleaseEvent(QMouseEvent *event)
 		}
 	}
 
-	if (event->button() == Qt::LeftButton && !isPopupVisible() && SettingsManager::getOption(SettingsManager::AddressField_ShowSuggestionsOnFocusOption).toBool() && HistoryManager::getTypedHistoryModel()->rowCount() > 0)
+	if (event->button() == Qt::LeftButton && !isPopupVisible() && SettingsManager::getOption(SettingsManager::AddressField_ShowSuggestionsOnFocusOption).toBool() && HistoryManager::getTypedHistoryModel()->getEntriesAmount() > 0)
 	{
 		showCompletion(true);
 	}
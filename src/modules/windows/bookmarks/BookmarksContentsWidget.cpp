@@ -71,6 +71,10 @@ BookmarksContentsWidget::BookmarksContentsWidget(const QVariantMap &parameters,
 	}
 
 	connect(BookmarksManager::getModel(), &BookmarksModel::modelReset, this, &BookmarksContentsWidget::updateActions);
+	connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, [&]()
+	{
+		m_ui->bookmarksViewWidget->setExpanded(m_ui->bookmarksViewWidget->model()->index(0, 0), true);
+	});
 	connect(m_ui->propertiesButton, &QPushButton::clicked, this, &BookmarksContentsWidget::bookmarkProperties);
 	connect(m_ui->deleteButton, &QPushButton::clicked, this, &BookmarksContentsWidget::removeBookmark);
 	connect(m_ui->addButton, &QPushButton::clicked, this, &BookmarksContentsWidget::addBookmark);
@@ -18,6 +18,7 @@
 **************************************************************************/
 
 #include "HistoryContentsWidget.h"
+#include "HistoryEntriesModel.h"
 #include "../../../core/Application.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../core/Utils.h"
@@ -26,7 +27,6 @@
 
 #include "ui_HistoryContentsWidget.h"
 
-#include <QtCore/QTimer>
 #include <QtGui/QClipboard>
 #include <QtGui/QMouseEvent>
 #include <QtWidgets/QMenu>
@@ -35,45 +35,44 @@ namespace Otter
 {
 
 HistoryContentsWidget::HistoryContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
-	m_model(new QStandardItemModel(this)),
+	m_model(new HistoryEntriesModel(HistoryManager::getBrowsingHistoryModel(), this)),
 	m_isLoading(true),
 	m_ui(new Ui::HistoryContentsWidget)
 {
 	m_ui->setupUi(this);
 	m_ui->filterLineEditWidget->setClearOnEscape(true);
-
-	const QStringList groups({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
-	const QIcon icon(ThemesManager::createIcon(QLatin1String("inode-directory")));
-
-	for (int i = 0; i < groups.count(); ++i)
-	{
-		m_model->appendRow(new QStandardItem(icon, groups.at(i)));
-	}
-
-	m_model->setHorizontalHeaderLabels({tr("Address"), tr("Title"), tr("Date")});
-	m_model->setHeaderData(0, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
-	m_model->setHeaderData(1, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
-	m_model->setSortRole(Qt::DisplayRole);
-
 	m_ui->historyViewWidget->setViewMode(ItemViewWidget::TreeView);
 	m_ui->historyViewWidget->setModel(m_model, true);
-	m_ui->historyViewWidget->setSortRoleMapping({{2, TimeVisitedRole}});
+	m_ui->historyViewWidget->setSortRoleMapping({{2, HistoryEntriesModel::TimeVisitedRole}});
 	m_ui->historyViewWidget->installEventFilter(this);
 	m_ui->historyViewWidget->viewport()->installEventFilter(this);
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		m_ui->historyViewWidget->setRowHidden(i, m_model->invisibleRootItem()->index(), true);
-	}
-
-	QTimer::singleShot(100, this, &HistoryContentsWidget::populateEntries);
+	populateEntries();
 
 	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::cleared, this, &HistoryContentsWidget::populateEntries);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryAdded, this, &HistoryContentsWidget::handleEntryAdded);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryModified, this, &HistoryContentsWidget::handleEntryModified);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryRemoved, this, &HistoryContentsWidget::handleEntryRemoved);
 	connect(HistoryManager::getInstance(), &HistoryManager::dayChanged, this, &HistoryContentsWidget::populateEntries);
-	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->historyViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_model, &HistoryEntriesModel::rowsInserted, this, [&](const QModelIndex &parent)
+	{
+		if (parent.isValid() && !parent.parent().isValid() && m_model->rowCount(parent) > 0 && m_ui->historyViewWidget->isRowHidden(parent.row(), {}))
+		{
+			updateGroups();
+
+			if (SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString() == QLatin1String("first"))
+			{
+				expandFirstGroup();
+			}
+		}
+	});
+	connect(m_model, &HistoryEntriesModel::rowsRemoved, this, &HistoryContentsWidget::updateGroups);
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, [&](const QString &text)
+	{
+		m_model->setFilterString(text);
+
+		updateGroups();
+		updateSorting();
+		expandGroups();
+	});
+	connect(m_ui->historyViewWidget, &ItemViewWidget::sortChanged, this, &HistoryContentsWidget::updateSorting);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::doubleClicked, this, &HistoryContentsWidget::openEntry);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::customContextMenuRequested, this, &HistoryContentsWidget::showContextMenu);
 }
@@ -91,14 +90,7 @@ void HistoryContentsWidget::changeEvent(QEvent *event)
 	{
 		m_ui->retranslateUi(this);
 
-		const QStringList groups({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
-
-		for (int i = 0; i < groups.count(); ++i)
-		{
-			m_model->setData(m_model->index(i, 0), groups.at(i), Qt::DisplayRole);
-		}
-
-		m_model->setHorizontalHeaderLabels({tr("Address"), tr("Title"), tr("Date")});
+		populateEntries();
 	}
 }
 
@@ -129,171 +121,58 @@ void HistoryContentsWidget::print(QPrinter *printer)
 
 void HistoryContentsWidget::populateEntries()
 {
-	const QDate date(QDate::currentDate());
-	const QVector<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365)});
-
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (groupItem)
-		{
-			groupItem->setData(dates.value(i, QDate()), GroupDateRole);
-			groupItem->removeRows(0, groupItem->rowCount());
-		}
-	}
-
-	const HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
-
-	for (int i = 0; i < model->rowCount(); ++i)
-	{
-		handleEntryAdded(static_cast<HistoryModel::Entry*>(model->item(i, 0)));
-	}
-
-	const QString expandBranches(SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString());
-
-	if (expandBranches == QLatin1String("first"))
-	{
-		for (int i = 0; i < m_model->rowCount(); ++i)
-		{
-			const QModelIndex index(m_model->index(i, 0));
-
-			if (m_model->rowCount(index) > 0)
-			{
-				m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
+	m_model->reload();
 
-				break;
-			}
-		}
-	}
-	else if (expandBranches == QLatin1String("all"))
-	{
-		m_ui->historyViewWidget->expandAll();
-	}
+	updateGroups();
+	updateSorting();
+	expandGroups();
 
 	m_isLoading = false;
 
 	emit loadingStateChanged(WebWidget::FinishedLoadingState);
 }
 
-void HistoryContentsWidget::removeEntry()
+void HistoryContentsWidget::updateGroups()
 {
-	const quint64 entry(getEntry(m_ui->historyViewWidget->currentIndex()));
-
-	if (entry > 0)
+	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
-		HistoryManager::removeEntry(entry);
+		m_ui->historyViewWidget->setRowHidden(i, {}, !m_model->hasChildren(m_model->index(i, 0)));
 	}
 }
 
-void HistoryContentsWidget::removeDomainEntries()
+void HistoryContentsWidget::updateSorting()
 {
-	const QStandardItem *domainItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	const int column(m_ui->historyViewWidget->getSortColumn());
 
-	if (!domainItem)
+	if (column >= 0 && (column != 2 || m_ui->historyViewWidget->getSortOrder() != Qt::DescendingOrder))
 	{
-		return;
-	}
+		m_model->fetchAll();
 
-	const QString host(QUrl(domainItem->text()).host());
-	QVector<quint64> entries;
-
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		const QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (!groupItem)
-		{
-			continue;
-		}
-
-		for (int j = (groupItem->rowCount() - 1); j >= 0; --j)
-		{
-			const QStandardItem *entryItem(groupItem->child(j, 0));
-
-			if (entryItem && host == QUrl(entryItem->text()).host())
-			{
-				entries.append(entryItem->data(IdentifierRole).toULongLong());
-			}
-		}
+		updateGroups();
 	}
-
-	HistoryManager::removeEntries(entries);
 }
 
-void HistoryContentsWidget::openEntry()
+void HistoryContentsWidget::expandGroups()
 {
-	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
+	const QString expandBranches(SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString());
 
-	if (!index.isValid() || index.parent() == m_model->invisibleRootItem()->index())
+	if (!m_ui->filterLineEditWidget->text().isEmpty() || expandBranches == QLatin1String("all"))
 	{
-		return;
+		m_ui->historyViewWidget->expandAll();
 	}
-
-	const QUrl url(index.sibling(index.row(), 0).data(Qt::DisplayRole).toString());
-
-	if (url.isValid())
+	else if (expandBranches == QLatin1String("first"))
 	{
-		const QAction *action(qobject_cast<QAction*>(sender()));
-		MainWindow *mainWindow(MainWindow::findMainWindow(this));
-
-		if (action && mainWindow)
-		{
-			mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), url}, {QLatin1String("hints"), QVariant(static_cast<SessionsManager::OpenHints>(action->data().toInt()))}});
-		}
+		expandFirstGroup();
 	}
 }
 
-void HistoryContentsWidget::handleEntryAdded(HistoryModel::Entry *entry)
+void HistoryContentsWidget::expandFirstGroup()
 {
-	if (!entry || !entry->isValid() || findEntry(entry->getIdentifier()))
-	{
-		return;
-	}
-
-	QStandardItem *groupItem(nullptr);
-
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		groupItem = m_model->item(i, 0);
-
-		const QDate date(groupItem ? groupItem->data(GroupDateRole).toDate() : QDate());
-
-		if (!date.isValid() || entry->getTimeVisited().date() >= date)
-		{
-			break;
-		}
-
-		groupItem = nullptr;
-	}
-
-	if (!groupItem)
-	{
-		return;
-	}
-
-	QList<QStandardItem*> entryItems({new QStandardItem(entry->getIcon(), entry->getUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')))), new QStandardItem(entry->getTitle()), new QStandardItem(Utils::formatDateTime(entry->getTimeVisited()))});
-	entryItems[0]->setData(entry->getIdentifier(), IdentifierRole);
-	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setData(entry->getTimeVisited(), TimeVisitedRole);
-	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setToolTip(Utils::formatDateTime(entry->getTimeVisited(), {}, false));
-
-	groupItem->appendRow(entryItems);
-
-	m_ui->historyViewWidget->setRowHidden(groupItem->row(), groupItem->index().parent(), false);
-
-	if (!sender() || groupItem->rowCount() != 1 || SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString() != QLatin1String("first"))
-	{
-		return;
-	}
-
 	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
 		const QModelIndex index(m_model->index(i, 0));
 
-		if (m_model->rowCount(index) > 0)
+		if (m_model->hasChildren(index))
 		{
 			m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
 
@@ -302,51 +181,47 @@ void HistoryContentsWidget::handleEntryAdded(HistoryModel::Entry *entry)
 	}
 }
 
-void HistoryContentsWidget::handleEntryModified(HistoryModel::Entry *entry)
+void HistoryContentsWidget::removeEntry()
 {
-	if (!entry || !entry->isValid())
+	const quint64 entry(getEntry(m_ui->historyViewWidget->currentIndex()));
+
+	if (entry > 0)
 	{
-		return;
+		HistoryManager::removeEntry(entry);
 	}
+}
 
-	QStandardItem *entryItem(findEntry(entry->getIdentifier()));
+void HistoryContentsWidget::removeDomainEntries()
+{
+	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-	if (!entryItem)
+	if (getEntry(index) == 0)
 	{
-		handleEntryAdded(entry);
-
 		return;
 	}
 
-	entryItem->setIcon(entry->getIcon());
-	entryItem->setText(entry->getUrl().toDisplayString());
-	entryItem->parent()->child(entryItem->row(), 1)->setText(entry->getTitle());
-	entryItem->parent()->child(entryItem->row(), 2)->setText(Utils::formatDateTime(entry->getTimeVisited()));
+	HistoryManager::removeEntries(HistoryManager::getBrowsingHistoryModel()->getHostEntries(Utils::extractHost(QUrl(index.sibling(index.row(), 0).data(Qt::DisplayRole).toString()))));
 }
 
-void HistoryContentsWidget::handleEntryRemoved(HistoryModel::Entry *entry)
+void HistoryContentsWidget::openEntry()
 {
-	if (!entry || !entry->isValid())
-	{
-		return;
-	}
-
-	QStandardItem *entryItem(findEntry(entry->getIdentifier()));
+	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-	if (!entryItem)
+	if (!index.isValid() || !index.parent().isValid())
 	{
 		return;
 	}
 
-	QStandardItem *groupItem(entryItem->parent());
+	const QUrl url(index.sibling(index.row(), 0).data(Qt::DisplayRole).toString());
 
-	if (groupItem)
+	if (url.isValid())
 	{
-		m_model->removeRow(entryItem->row(), groupItem->index());
+		const QAction *action(qobject_cast<QAction*>(sender()));
+		MainWindow *mainWindow(MainWindow::findMainWindow(this));
 
-		if (groupItem->rowCount() == 0)
+		if (action && mainWindow)
 		{
-			m_ui->historyViewWidget->setRowHidden(groupItem->row(), m_model->invisibleRootItem()->index(), true);
+			mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), url}, {QLatin1String("hints"), QVariant(static_cast<SessionsManager::OpenHints>(action->data().toInt()))}});
 		}
 	}
 }
@@ -368,20 +243,20 @@ void HistoryContentsWidget::showContextMenu(const QPoint &position)
 		menu.addSeparator();
 		menu.addAction(tr("Add to Bookmarks…"), this, [&]()
 		{
-			const QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+			const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-			if (entryItem)
+			if (getEntry(index) > 0)
 			{
-				Application::triggerAction(ActionsManager::BookmarkPageAction, {{QLatin1String("url"), entryItem->text()}, {QLatin1String("title"), m_ui->historyViewWidget->currentIndex().sibling(m_ui->historyViewWidget->currentIndex().row(), 1).data(Qt::DisplayRole).toString()}}, parentWidget());
+				Application::triggerAction(ActionsManager::BookmarkPageAction, {{QLatin1String("url"), index.sibling(index.row(), 0).data(Qt::DisplayRole).toString()}, {QLatin1String("title"), index.sibling(index.row(), 1).data(Qt::DisplayRole).toString()}}, parentWidget());
 			}
 		});
 		menu.addAction(tr("Copy Link to Clipboard"), this, [&]()
 		{
-			const QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+			const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-			if (entryItem)
+			if (getEntry(index) > 0)
 			{
-				QGuiApplication::clipboard()->setText(entryItem->text());
+				QGuiApplication::clipboard()->setText(index.sibling(index.row(), 0).data(Qt::DisplayRole).toString());
 			}
 		});
 		menu.addSeparator();
@@ -393,29 +268,6 @@ void HistoryContentsWidget::showContextMenu(const QPoint &position)
 	menu.exec(m_ui->historyViewWidget->mapToGlobal(position));
 }
 
-QStandardItem* HistoryContentsWidget::findEntry(quint64 identifier)
-{
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		const QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (groupItem)
-		{
-			for (int j = 0; j < groupItem->rowCount(); ++j)
-			{
-				QStandardItem *entryItem(groupItem->child(j, 0));
-
-				if (entryItem && entryItem->data(IdentifierRole).toULongLong() == identifier)
-				{
-					return entryItem;
-				}
-			}
-		}
-	}
-
-	return nullptr;
-}
-
 QString HistoryContentsWidget::getTitle() const
 {
 	return tr("History");
@@ -443,7 +295,7 @@ WebWidget::LoadingState HistoryContentsWidget::getLoadingState() const
 
 quint64 HistoryContentsWidget::getEntry(const QModelIndex &index) const
 {
-	return ((index.isValid() && index.parent().isValid() && index.parent().parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(IdentifierRole).toULongLong() : 0);
+	return ((index.isValid() && index.parent().isValid() && !index.parent().parent().isValid()) ? index.sibling(index.row(), 0).data(HistoryEntriesModel::IdentifierRole).toULongLong() : 0);
 }
 
 bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
@@ -475,7 +327,7 @@ bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
 		{
 			const QModelIndex entryIndex(m_ui->historyViewWidget->currentIndex());
 
-			if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
+			if (!entryIndex.isValid() || !entryIndex.parent().isValid())
 			{
 				return ContentsWidget::eventFilter(object, event);
 			}
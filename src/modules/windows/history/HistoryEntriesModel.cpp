@@ -0,0 +1,562 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryEntriesModel.h"
+#include "../../../core/HistoryManager.h"
+#include "../../../core/ThemesManager.h"
+#include "../../../core/Utils.h"
+#include "../../../ui/ItemViewWidget.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <algorithm>
+#include <limits>
+
+namespace Otter
+{
+
+HistoryEntriesModel::HistoryEntriesModel(HistoryModel *model, QObject *parent) : QAbstractItemModel(parent),
+	m_model(model)
+{
+	reload();
+
+	connect(m_model, &HistoryModel::entryAdded, this, &HistoryEntriesModel::handleEntryAdded);
+	connect(m_model, &HistoryModel::entryModified, this, &HistoryEntriesModel::handleEntryModified);
+	connect(m_model, &HistoryModel::entriesRemoved, this, &HistoryEntriesModel::handleEntriesRemoved);
+}
+
+void HistoryEntriesModel::reload()
+{
+	beginResetModel();
+
+	m_groups.clear();
+	m_identifiers.clear();
+
+	const QDate date(QDate::currentDate());
+	const QVector<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365), QDate()});
+	qint64 maximumTime(std::numeric_limits<qint64>::max());
+
+	m_groups.reserve(dates.count());
+
+	for (int i = 0; i < dates.count(); ++i)
+	{
+		Group group;
+		group.date = dates.at(i);
+		group.minimumTime = (group.date.isValid() ? QDateTime(group.date, QTime(0, 0)).toMSecsSinceEpoch() : std::numeric_limits<qint64>::min());
+		group.nextTime = maximumTime;
+
+		if (m_filterString.isEmpty())
+		{
+			const QVector<HistoryStore::Visit> visits(m_model->getVisits(group.nextTime, 0, 1));
+
+			group.canFetchMore = (!visits.isEmpty() && visits.first().timeVisited >= group.minimumTime);
+		}
+
+		m_groups.append(group);
+
+		maximumTime = group.minimumTime;
+	}
+
+	if (!m_filterString.isEmpty())
+	{
+		const QVector<HistoryStore::Visit> visits(m_model->findMatchingVisits(m_filterString));
+
+		for (int i = 0; i < visits.count(); ++i)
+		{
+			const int group(getGroup(visits.at(i).timeVisited));
+
+			if (group >= 0)
+			{
+				m_groups[group].entries.append(createEntry(visits.at(i)));
+
+				m_identifiers[visits.at(i).identifier] = visits.at(i).timeVisited;
+			}
+		}
+	}
+
+	endResetModel();
+}
+
+void HistoryEntriesModel::fetchAll()
+{
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		fetchEntries(i, std::numeric_limits<int>::max());
+	}
+}
+
+void HistoryEntriesModel::fetchMore(const QModelIndex &parent)
+{
+	if (parent.isValid() && !parent.parent().isValid())
+	{
+		fetchEntries(parent.row(), 200);
+	}
+}
+
+void HistoryEntriesModel::fetchEntries(int groupRow, int amount)
+{
+	if (groupRow < 0 || groupRow >= m_groups.count() || !m_groups.at(groupRow).canFetchMore)
+	{
+		return;
+	}
+
+	Group &group(m_groups[groupRow]);
+	const QVector<HistoryStore::Visit> visits(m_model->getVisits(group.nextTime, group.nextIdentifier, amount));
+	QVector<Entry> entries;
+	entries.reserve(visits.count());
+
+	group.canFetchMore = (visits.count() == amount);
+
+	for (int i = 0; i < visits.count(); ++i)
+	{
+		if (visits.at(i).timeVisited < group.minimumTime)
+		{
+			group.canFetchMore = false;
+
+			break;
+		}
+
+		entries.append(createEntry(visits.at(i)));
+	}
+
+	if (entries.isEmpty())
+	{
+		return;
+	}
+
+	group.nextTime = entries.last().timeVisited;
+	group.nextIdentifier = entries.last().identifier;
+
+	beginInsertRows(index(groupRow, 0), group.entries.count(), (group.entries.count() + entries.count() - 1));
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		m_identifiers[entries.at(i).identifier] = entries.at(i).timeVisited;
+	}
+
+	group.entries.append(entries);
+
+	endInsertRows();
+}
+
+void HistoryEntriesModel::handleEntryAdded(HistoryModel::Entry *entry)
+{
+	if (!entry || !entry->isValid() || m_identifiers.contains(entry->getIdentifier()))
+	{
+		return;
+	}
+
+	const HistoryStore::Visit visit(m_model->getVisit(entry->getIdentifier()));
+
+	if (!visit.isValid() || (!m_filterString.isEmpty() && !visit.title.contains(m_filterString, Qt::CaseInsensitive) && !m_model->getVisitUrl(visit).toString().contains(m_filterString, Qt::CaseInsensitive)))
+	{
+		return;
+	}
+
+	const int groupRow(getGroup(visit.timeVisited));
+
+	if (groupRow < 0)
+	{
+		return;
+	}
+
+	Group &group(m_groups[groupRow]);
+	const int row(getEntryPosition(groupRow, visit.timeVisited, visit.identifier));
+
+	if (row == group.entries.count() && group.canFetchMore)
+	{
+		return;
+	}
+
+	beginInsertRows(index(groupRow, 0), row, row);
+
+	group.entries.insert(row, createEntry(visit));
+
+	m_identifiers[visit.identifier] = visit.timeVisited;
+
+	endInsertRows();
+}
+
+void HistoryEntriesModel::handleEntryModified(HistoryModel::Entry *entry)
+{
+	if (!entry || !entry->isValid())
+	{
+		return;
+	}
+
+	const QModelIndex entryIndex(findEntry(entry->getIdentifier()));
+
+	if (!entryIndex.isValid())
+	{
+		handleEntryAdded(entry);
+
+		return;
+	}
+
+	const HistoryStore::Visit visit(m_model->getVisit(entry->getIdentifier()));
+
+	if (visit.isValid())
+	{
+		m_groups[entryIndex.parent().row()].entries[entryIndex.row()] = createEntry(visit);
+
+		emit dataChanged(entryIndex, entryIndex.sibling(entryIndex.row(), 2));
+	}
+}
+
+void HistoryEntriesModel::handleEntriesRemoved(const QVector<quint64> &identifiers)
+{
+	QVector<QVector<int> > rows(m_groups.count());
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		const QModelIndex entryIndex(findEntry(identifiers.at(i)));
+
+		if (entryIndex.isValid())
+		{
+			rows[entryIndex.parent().row()].append(entryIndex.row());
+
+			m_identifiers.remove(identifiers.at(i));
+		}
+	}
+
+	for (int i = 0; i < rows.count(); ++i)
+	{
+		QVector<int> &groupRows(rows[i]);
+
+		if (groupRows.isEmpty())
+		{
+			continue;
+		}
+
+		std::sort(groupRows.begin(), groupRows.end());
+
+		const QModelIndex groupIndex(index(i, 0));
+
+		for (int j = (groupRows.count() - 1); j >= 0;)
+		{
+			int first(j);
+
+			while (first > 0 && groupRows.at(first - 1) == (groupRows.at(first) - 1))
+			{
+				--first;
+			}
+
+			beginRemoveRows(groupIndex, groupRows.at(first), groupRows.at(j));
+
+			m_groups[i].entries.remove(groupRows.at(first), (j - first + 1));
+
+			endRemoveRows();
+
+			j = (first - 1);
+		}
+	}
+}
+
+void HistoryEntriesModel::setFilterString(const QString &filter)
+{
+	if (filter != m_filterString)
+	{
+		m_filterString = filter;
+
+		reload();
+	}
+}
+
+HistoryEntriesModel::Entry HistoryEntriesModel::createEntry(const HistoryStore::Visit &visit) const
+{
+	Entry entry;
+	entry.title = visit.title;
+	entry.url = m_model->getVisitUrl(visit);
+	entry.timeVisited = visit.timeVisited;
+	entry.identifier = visit.identifier;
+
+	return entry;
+}
+
+QModelIndex HistoryEntriesModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (row < 0 || column < 0 || column >= columnCount(parent))
+	{
+		return {};
+	}
+
+	if (!parent.isValid())
+	{
+		return ((row < m_groups.count()) ? createIndex(row, column, static_cast<quintptr>(0)) : QModelIndex());
+	}
+
+	if (parent.parent().isValid() || parent.row() >= m_groups.count() || row >= m_groups.at(parent.row()).entries.count())
+	{
+		return {};
+	}
+
+	return createIndex(row, column, static_cast<quintptr>(parent.row() + 1));
+}
+
+QModelIndex HistoryEntriesModel::parent(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return {};
+	}
+
+	return createIndex((static_cast<int>(index.internalId()) - 1), 0, static_cast<quintptr>(0));
+}
+
+QModelIndex HistoryEntriesModel::findEntry(quint64 identifier) const
+{
+	const QHash<quint64, qint64>::const_iterator iterator(m_identifiers.constFind(identifier));
+
+	if (iterator == m_identifiers.constEnd())
+	{
+		return {};
+	}
+
+	const int group(getGroup(iterator.value()));
+
+	if (group < 0)
+	{
+		return {};
+	}
+
+	const QVector<Entry> &entries(m_groups.at(group).entries);
+	const int row(getEntryPosition(group, iterator.value(), identifier));
+
+	if (row >= entries.count() || entries.at(row).identifier != identifier)
+	{
+		return {};
+	}
+
+	return createIndex(row, 0, static_cast<quintptr>(group + 1));
+}
+
+QVariant HistoryEntriesModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return {};
+	}
+
+	if (index.internalId() == 0)
+	{
+		if (index.column() != 0 || index.row() >= m_groups.count())
+		{
+			return {};
+		}
+
+		switch (role)
+		{
+			case Qt::DisplayRole:
+				switch (index.row())
+				{
+					case 0:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Today");
+					case 1:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Yesterday");
+					case 2:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Earlier This Week");
+					case 3:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Previous Week");
+					case 4:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Earlier This Month");
+					case 5:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Earlier This Year");
+					default:
+						return QCoreApplication::translate("Otter::HistoryContentsWidget", "Older");
+				}
+			case Qt::DecorationRole:
+				return ThemesManager::createIcon(QLatin1String("inode-directory"));
+			case GroupDateRole:
+				return m_groups.at(index.row()).date;
+			default:
+				break;
+		}
+
+		return {};
+	}
+
+	const int group(static_cast<int>(index.internalId()) - 1);
+
+	if (group >= m_groups.count() || index.row() >= m_groups.at(group).entries.count())
+	{
+		return {};
+	}
+
+	const Entry &entry(m_groups.at(group).entries.at(index.row()));
+
+	if (role == IdentifierRole)
+	{
+		return entry.identifier;
+	}
+
+	switch (index.column())
+	{
+		case 0:
+			if (role == Qt::DisplayRole)
+			{
+				return entry.url.toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')));
+			}
+
+			if (role == Qt::DecorationRole)
+			{
+				return HistoryManager::getIcon(entry.url);
+			}
+
+			break;
+		case 1:
+			if (role == Qt::DisplayRole)
+			{
+				return (entry.title.isNull() ? QCoreApplication::translate("Otter::HistoryEntryItem", "(Untitled)") : entry.title);
+			}
+
+			break;
+		case 2:
+			if (role == Qt::DisplayRole)
+			{
+				return Utils::formatDateTime(QDateTime::fromMSecsSinceEpoch(entry.timeVisited, Qt::UTC));
+			}
+
+			if (role == Qt::ToolTipRole)
+			{
+				return Utils::formatDateTime(QDateTime::fromMSecsSinceEpoch(entry.timeVisited, Qt::UTC), {}, false);
+			}
+
+			if (role == TimeVisitedRole)
+			{
+				return QDateTime::fromMSecsSinceEpoch(entry.timeVisited, Qt::UTC);
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return {};
+}
+
+QVariant HistoryEntriesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal)
+	{
+		return {};
+	}
+
+	if (role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+			case 0:
+				return QCoreApplication::translate("Otter::HistoryContentsWidget", "Address");
+			case 1:
+				return QCoreApplication::translate("Otter::HistoryContentsWidget", "Title");
+			case 2:
+				return QCoreApplication::translate("Otter::HistoryContentsWidget", "Date");
+			default:
+				break;
+		}
+	}
+	else if (role == HeaderViewWidget::WidthRole && section < 2)
+	{
+		return 300;
+	}
+
+	return {};
+}
+
+Qt::ItemFlags HistoryEntriesModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
+
+	if (index.internalId() == 0)
+	{
+		return (Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+	}
+
+	return (Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren);
+}
+
+int HistoryEntriesModel::getGroup(qint64 timeVisited) const
+{
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		if (timeVisited >= m_groups.at(i).minimumTime)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int HistoryEntriesModel::getEntryPosition(int group, qint64 timeVisited, quint64 identifier) const
+{
+	const QVector<Entry> &entries(m_groups.at(group).entries);
+
+	return static_cast<int>(std::lower_bound(entries.constBegin(), entries.constEnd(), identifier, [&](const Entry &entry, quint64)
+	{
+		return (entry.timeVisited > timeVisited || (entry.timeVisited == timeVisited && entry.identifier > identifier));
+	}) - entries.constBegin());
+}
+
+int HistoryEntriesModel::rowCount(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return m_groups.count();
+	}
+
+	if (parent.internalId() != 0 || parent.column() != 0 || parent.row() >= m_groups.count())
+	{
+		return 0;
+	}
+
+	return m_groups.at(parent.row()).entries.count();
+}
+
+int HistoryEntriesModel::columnCount(const QModelIndex &parent) const
+{
+	Q_UNUSED(parent)
+
+	return 3;
+}
+
+bool HistoryEntriesModel::canFetchMore(const QModelIndex &parent) const
+{
+	return (parent.isValid() && parent.internalId() == 0 && parent.row() < m_groups.count() && m_groups.at(parent.row()).canFetchMore);
+}
+
+bool HistoryEntriesModel::hasChildren(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return !m_groups.isEmpty();
+	}
+
+	if (parent.internalId() != 0 || parent.row() >= m_groups.count())
+	{
+		return false;
+	}
+
+	return (!m_groups.at(parent.row()).entries.isEmpty() || m_groups.at(parent.row()).canFetchMore);
+}
+
+}
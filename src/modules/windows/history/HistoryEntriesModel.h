@@ -0,0 +1,97 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2026 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYENTRIESMODEL_H
+#define OTTER_HISTORYENTRIESMODEL_H
+
+#include "../../../core/HistoryModel.h"
+
+#include <QtCore/QAbstractItemModel>
+
+namespace Otter
+{
+
+class HistoryEntriesModel final : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	enum DataRole
+	{
+		IdentifierRole = Qt::UserRole,
+		TimeVisitedRole,
+		GroupDateRole
+	};
+
+	explicit HistoryEntriesModel(HistoryModel *model, QObject *parent = nullptr);
+
+	void reload();
+	void fetchAll();
+	void fetchMore(const QModelIndex &parent) override;
+	void setFilterString(const QString &filter);
+	QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+	QModelIndex parent(const QModelIndex &index) const override;
+	QModelIndex findEntry(quint64 identifier) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex &index) const override;
+	int rowCount(const QModelIndex &parent = {}) const override;
+	int columnCount(const QModelIndex &parent = {}) const override;
+	bool canFetchMore(const QModelIndex &parent) const override;
+	bool hasChildren(const QModelIndex &parent = {}) const override;
+
+protected:
+	struct Entry final
+	{
+		QString title;
+		QUrl url;
+		qint64 timeVisited = 0;
+		quint64 identifier = 0;
+	};
+
+	struct Group final
+	{
+		QVector<Entry> entries;
+		QDate date;
+		qint64 minimumTime = 0;
+		qint64 nextTime = 0;
+		quint64 nextIdentifier = 0;
+		bool canFetchMore = false;
+	};
+
+	void fetchEntries(int groupRow, int amount);
+	Entry createEntry(const HistoryStore::Visit &visit) const;
+	int getGroup(qint64 timeVisited) const;
+	int getEntryPosition(int group, qint64 timeVisited, quint64 identifier) const;
+
+protected slots:
+	void handleEntryAdded(HistoryModel::Entry *entry);
+	void handleEntryModified(HistoryModel::Entry *entry);
+	void handleEntriesRemoved(const QVector<quint64> &identifiers);
+
+private:
+	HistoryModel *m_model;
+	QVector<Group> m_groups;
+	QHash<quint64, qint64> m_identifiers;
+	QString m_filterString;
+};
+
+}
+
+#endif
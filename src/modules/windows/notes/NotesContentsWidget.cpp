@@ -68,6 +68,10 @@ NotesContentsWidget::NotesContentsWidget(const QVariantMap &parameters, Window *
 		emit arbitraryActionsStateChanged({ActionsManager::PasteAction});
 	});
 	connect(NotesManager::getModel(), &BookmarksModel::modelReset, this, &NotesContentsWidget::updateActions);
+	connect(NotesManager::getModel(), &BookmarksModel::loadingFinished, this, [&]()
+	{
+		m_ui->notesViewWidget->setExpanded(NotesManager::getModel()->getRootItem()->index(), true);
+	});
 	connect(m_ui->deleteButton, &QPushButton::clicked, this, &NotesContentsWidget::removeNote);
 	connect(m_ui->addButton, &QPushButton::clicked, this, &NotesContentsWidget::addNote);
 	connect(m_ui->textEditWidget, &TextEditWidget::textChanged, this, &NotesContentsWidget::updateText);
@@ -43,6 +43,7 @@ StartPageModel::StartPageModel(QObject *parent) : QStandardItemModel(parent),
 	connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkMoved, this, &StartPageModel::handleBookmarkMoved);
 	connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkTrashed, this, &StartPageModel::handleBookmarkMoved);
 	connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkRemoved, this, &StartPageModel::handleBookmarkRemoved);
+	connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, &StartPageModel::reloadModel);
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &StartPageModel::handleOptionChanged);
 }
 
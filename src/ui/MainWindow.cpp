@@ -202,6 +202,10 @@ MainWindow::MainWindow(const QVariantMap &parameters, const Session::MainWindow
 	connect(ToolBarsManager::getInstance(), &ToolBarsManager::toolBarRemoved, this, &MainWindow::handleToolBarRemoved);
 	connect(TransfersManager::getInstance(), &TransfersManager::transferStarted, this, &MainWindow::handleTransferStarted);
 	connect(m_workspace, &WorkspaceWidget::arbitraryActionsStateChanged, this, &MainWindow::arbitraryActionsStateChanged);
+	connect(m_tabBar, &TabBarWidget::tabMoved, this, [&]()
+	{
+		SessionsManager::markSessionAsModified();
+	});
 
 	if (session.geometry.isEmpty())
 	{
@@ -1295,6 +1299,16 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 	}
 	else
 	{
+		const bool deferLoading(SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool());
+
+		for (int i = 0; (index < 0 && i < session.windows.count()); ++i)
+		{
+			if (session.windows.at(i).state.state != Qt::WindowMinimized)
+			{
+				index = i;
+			}
+		}
+
 		for (int i = 0; i < session.windows.count(); ++i)
 		{
 			QVariantMap parameters({{QLatin1String("size"), ((session.windows.at(i).state.state == Qt::WindowMaximized || !session.windows.at(i).state.geometry.isValid()) ? m_workspace->size() : session.windows.at(i).state.geometry.size())}});
@@ -1305,11 +1319,11 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 			}
 
 			Window *window(new Window(parameters, nullptr, this));
-			window->setSession(session.windows.at(i), SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool());
+			window->setSession(session.windows.at(i), true);
 
-			if (index < 0 && session.windows.at(i).state.state != Qt::WindowMinimized)
+			if (!deferLoading && i != index)
 			{
-				index = i;
+				m_pendingWindows.append(window->getIdentifier());
 			}
 
 			addWindow(window, SessionsManager::DefaultOpen, -1, session.windows.at(i).state, session.windows.at(i).isAlwaysOnTop);
@@ -1324,9 +1338,34 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 
 	m_workspace->markAsRestored();
 
+	if (!m_pendingWindows.isEmpty())
+	{
+		QTimer::singleShot(0, this, &MainWindow::loadPendingWindows);
+	}
+
 	emit sessionRestored();
 }
 
+void MainWindow::loadPendingWindows()
+{
+	while (!m_pendingWindows.isEmpty())
+	{
+		Window *window(m_windows.value(m_pendingWindows.takeFirst()));
+
+		if (window)
+		{
+			window->getContentsWidget();
+
+			break;
+		}
+	}
+
+	if (!m_pendingWindows.isEmpty())
+	{
+		QTimer::singleShot(0, this, &MainWindow::loadPendingWindows);
+	}
+}
+
 void MainWindow::restoreClosedWindow(int index)
 {
 	if (index < 0 || index >= m_closedWindows.count())
@@ -1479,6 +1518,8 @@ void MainWindow::addWindow(Window *window, SessionsManager::OpenHints hints, int
 	connect(window, &Window::isPinnedChanged, this, &MainWindow::handleWindowIsPinnedChanged);
 	connect(window, &Window::requestedNewWindow, this, &MainWindow::openWindow);
 
+	SessionsManager::markSessionAsModified();
+
 	emit windowAdded(window->getIdentifier());
 }
 
@@ -1531,6 +1572,8 @@ void MainWindow::moveWindow(Window *window, MainWindow *mainWindow, const QVaria
 		emit arbitraryActionsStateChanged({ActionsManager::ClosePrivateTabsAction});
 	}
 
+	SessionsManager::markSessionAsModified();
+
 	emit windowRemoved(window->getIdentifier());
 }
 
@@ -1734,6 +1777,8 @@ void MainWindow::handleRequestedCloseWindow(Window *window)
 		m_tabSwitchingOrderList.removeAll(window->getIdentifier());
 	}
 
+	SessionsManager::markSessionAsModified();
+
 	emit windowRemoved(window->getIdentifier());
 
 	m_windows.remove(window->getIdentifier());
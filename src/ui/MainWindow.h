@@ -121,6 +121,7 @@ protected slots:
 	void handleToolBarAdded(int identifier);
 	void handleToolBarRemoved(int identifier);
 	void handleTransferStarted();
+	void loadPendingWindows();
 	void setActiveWindow(Window *window);
 	void setStatusMessage(const QString &message);
 	void updateWindowTitle();
@@ -141,6 +142,7 @@ private:
 	QVector<Window*> m_privateWindows;
 	QVector<Session::ClosedWindow> m_closedWindows;
 	QVector<quint64> m_tabSwitchingOrderList;
+	QVector<quint64> m_pendingWindows;
 	QHash<quint64, Window*> m_windows;
 	QMap<QString, QVector<int> > m_splitters;
 	QMap<int, ToolBarWidget*> m_toolBars;
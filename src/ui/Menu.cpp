@@ -123,6 +123,7 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 				if (!parentMenu || parentMenu->getRole() != m_role)
 				{
 					connect(BookmarksManager::getModel(), &BookmarksModel::modelModified, this, &Menu::clearBookmarksMenu);
+					connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, &Menu::clearBookmarksMenu);
 				}
 
 				if (role == BookmarksMenu)
@@ -214,6 +215,7 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 				if (!parentMenu || parentMenu->getRole() != m_role)
 				{
 					connect(NotesManager::getModel(), &BookmarksModel::modelModified, this, &Menu::clearBookmarksMenu);
+					connect(NotesManager::getModel(), &BookmarksModel::loadingFinished, this, &Menu::clearNotesMenu);
 				}
 
 				connect(this, &Menu::aboutToShow, this, &Menu::populateNotesMenu);
@@ -666,6 +668,13 @@ void Menu::populateBookmarksMenu()
 		return;
 	}
 
+	if (BookmarksManager::getModel()->isLoading())
+	{
+		addAction(tr("Loading Bookmarks…"))->setEnabled(false);
+
+		return;
+	}
+
 	MainWindow *mainWindow(MainWindow::findMainWindow(parent()));
 	ActionExecutor::Object executor(mainWindow, mainWindow);
 
@@ -1150,6 +1159,13 @@ void Menu::populateNotesMenu()
 		return;
 	}
 
+	if (NotesManager::getModel()->isLoading())
+	{
+		addAction(tr("Loading Notes…"))->setEnabled(false);
+
+		return;
+	}
+
 	const BookmarksModel::Bookmark *folderBookmark(NotesManager::getModel()->getBookmark(m_menuOptions.value(QLatin1String("bookmark")).toULongLong()));
 
 	for (int i = 0; i < folderBookmark->rowCount(); ++i)
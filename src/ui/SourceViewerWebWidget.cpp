@@ -290,7 +290,7 @@ void SourceViewerWebWidget::handleViewSourceReplyFinished()
 
 void SourceViewerWebWidget::handleZoomChanged()
 {
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(getWindowIdentifier());
 }
 
 void SourceViewerWebWidget::notifyEditingActionsStateChanged()
@@ -348,7 +348,7 @@ void SourceViewerWebWidget::setZoom(int zoom)
 	{
 		m_sourceEditWidget->setZoom(zoom);
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(getWindowIdentifier());
 
 		emit zoomChanged(zoom);
 	}
@@ -402,6 +402,17 @@ void ToolBarWidget::populateEntries()
 	switch (definition.type)
 	{
 		case ToolBarsManager::BookmarksBarType:
+			if (BookmarksManager::getModel()->isLoading())
+			{
+				m_bookmark = nullptr;
+
+				addAction(tr("Loading Bookmarks…"))->setEnabled(false);
+
+				connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, &ToolBarWidget::reload, Qt::UniqueConnection);
+
+				break;
+			}
+
 			m_bookmark = BookmarksManager::getBookmark(definition.bookmarksPath);
 
 			loadBookmarks();
@@ -85,6 +85,10 @@ WebWidget::WebWidget(const QVariantMap &parameters, WebBackend *backend, Content
 	{
 		emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::BookmarkCategory});
 	});
+	connect(BookmarksManager::getModel(), &BookmarksModel::loadingFinished, this, [&]()
+	{
+		emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::BookmarkCategory});
+	});
 	connect(PasswordsManager::getInstance(), &PasswordsManager::passwordsModified, this, [&]()
 	{
 		emit arbitraryActionsStateChanged({ActionsManager::FillPasswordAction});
@@ -684,7 +688,7 @@ void WebWidget::setOption(int identifier, const QVariant &value)
 		m_options[identifier] = value;
 	}
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(getWindowIdentifier());
 
 	switch (identifier)
 	{
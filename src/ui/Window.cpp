@@ -313,7 +313,7 @@ void Window::setOption(int identifier, const QVariant &value)
 			m_session.options[identifier] = value;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(getIdentifier());
 
 		emit optionChanged(identifier, value);
 	}
@@ -394,6 +394,8 @@ void Window::setPinned(bool isPinned)
 	{
 		m_isPinned = isPinned;
 
+		SessionsManager::markSessionAsModified();
+
 		emit arbitraryActionsStateChanged({ActionsManager::PinTabAction, ActionsManager::CloseTabAction});
 		emit isPinnedChanged(isPinned);
 	}
@@ -739,6 +741,11 @@ bool Window::isActive() const
 	return (isActiveWindow() && isAncestorOf(QApplication::focusWidget()));
 }
 
+bool Window::isAudible() const
+{
+	return (m_contentsWidget && !m_isAboutToClose && m_contentsWidget->getWebWidget() && m_contentsWidget->getWebWidget()->isAudible());
+}
+
 bool Window::isPinned() const
 {
 	return m_isPinned;
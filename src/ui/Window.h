@@ -79,6 +79,7 @@ public:
 	bool canZoom() const;
 	bool isAboutToClose() const override;
 	bool isActive() const;
+	bool isAudible() const;
 	bool isPinned() const;
 	bool isPrivate() const;
 